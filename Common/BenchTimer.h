@@ -0,0 +1,29 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// ------------------ ܲ ------------------
+
+/**
+ * @brief ѱĽдһ volatile ֹμŻ
+ */
+inline void benchSink(uint64_t v) {
+    static volatile uint64_t sink = 0;
+    sink = sink + v;
+}
+
+/**
+ * @brief ظִ rounds ֣һֵĺʱ룩
+ */
+template <class Body>
+double bestOf(unsigned int rounds, Body body) {
+    double best = 0;
+    for (unsigned int i = 0; i < rounds; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (i == 0 || t < best) best = t;
+    }
+    return best;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "OuiData.h"
+
+// ------------------ ̲ѯ ------------------
+// MAC ַǰ 3 ֽ (OUI) ƵĶӦϵڱʱɣ gen_oui.py
+// Сϣʽ򣺲ֻιϣһһλ
+// ļڴ棬ҲҪʼ
+// µǼǱpython3 gen_oui.py oui.txt OuiData.h ±롣
+
+/**
+ * @brief 32 λϣ (lowbias32) gen_oui.py е mix() һ
+ */
+constexpr uint32_t ouiMix(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+/**
+ * @brief  OUI ҳ
+ * @param oui 24 λ OUI 0x00000C
+ * @return ƣδǼʱ nullptr
+ */
+constexpr const char* ouiVendor(uint32_t oui) {
+    const uint32_t seed = OuiData<>::seeds[ouiMix(oui) % OUI_BUCKET_COUNT];
+    const OuiSlot& slot = OuiData<>::slots[ouiMix(oui + (seed + 1) * 0x9E3779B9u) % OUI_SLOT_COUNT];
+    // ֻеǼǹ OUIֵҲ䵽ĳλϣҪȽ
+    return slot.oui == oui ? OuiData<>::names[slot.name] : nullptr;
+}
+
+/**
+ * @brief MAC ַĳ
+ * @param mac 6 ֽ MAC ַ
+ * @return ƣ鲥ַعĵַ MAC ȣδǼǵ OUI  nullptr
+ */
+inline const char* macVendor(const uint8_t* mac) {
+    if (mac[0] & 0x03) {
+        return nullptr; // I/G λ U/L λλǰ 3 ֽڲǳ̵ OUI
+    }
+    return ouiVendor(((uint32_t)mac[0] << 16) | ((uint32_t)mac[1] << 8) | mac[2]);
+}
+
+// 00-00-0C Ǽǵ OUI ֮һ鲻˵ OuiData.h  ouiMix() һ£Ҫ gen_oui.py 
+static_assert(ouiVendor(0x00000C) != nullptr, "OuiData.h  ouiMix() һ");
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// ------------------ Эͼ ------------------
+// ͼָֻԭʼֽڣڴӳջָ볤ȣơڴ棻
+// ʱֻײ汾ţֶڷʱŰֽ
+// ݲԹײʱ valid() Ϊ falseʱ÷ֶΡͼڲָܳݡ
+
+const uint16_t ETH_TYPE_IPV4 = 0x0800;
+const uint16_t ETH_TYPE_ARP = 0x0806;
+const uint16_t ETH_TYPE_VLAN = 0x8100; // 802.1Q
+const uint16_t ETH_TYPE_QINQ = 0x88A8; // 802.1ad ǩ
+const uint16_t ETH_TYPE_IPV6 = 0x86DD;
+
+const uint8_t IP_PROTO_ICMP = 1;
+const uint8_t IP_PROTO_TCP = 6;
+const uint8_t IP_PROTO_UDP = 17;
+const uint8_t IP_PROTO_ICMPV6 = 58;
+
+inline uint16_t readBE16(const uint8_t* p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+inline uint32_t readBE32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/**
+ * @brief IP ЭŶӦƣδʶʱ nullptr
+ */
+inline const char* ipProtocolName(uint8_t proto) {
+    switch (proto) {
+    case IP_PROTO_ICMP:   return "ICMP";
+    case 2:               return "IGMP";
+    case IP_PROTO_TCP:    return "TCP";
+    case IP_PROTO_UDP:    return "UDP";
+    case 47:              return "GRE";
+    case 50:              return "ESP";
+    case IP_PROTO_ICMPV6: return "ICMPv6";
+    case 89:              return "OSPF";
+    case 132:             return "SCTP";
+    default:              return nullptr;
+    }
+}
+
+/**
+ * @brief 802.1Q / 802.1ad ǩ4ֽڣTCI + ڲֶΣ
+ */
+class VlanView {
+public:
+    static const size_t SIZE = 4;
+
+    VlanView() = default;
+    VlanView(const uint8_t* data, size_t len) : p(len >= SIZE ? data : nullptr) {
+    }
+
+    bool valid() const { return p != nullptr; }
+    uint8_t priority() const { return (uint8_t)(p[0] >> 5); }
+    bool dropEligible() const { return (p[0] & 0x10) != 0; }
+    uint16_t vlanId() const { return (uint16_t)(readBE16(p) & 0x0FFF); }
+    uint16_t etherType() const { return readBE16(p + 2); } // ǩֶ֮
+
+private:
+    const uint8_t* p = nullptr;
+};
+
+/**
+ * @brief ARP ģRFC 826ַɱе hlen / plen 
+ */
+class ArpView {
+public:
+    static const uint16_t OP_REQUEST = 1;
+    static const uint16_t OP_REPLY = 2;
+
+    ArpView() = default;
+    ArpView(const uint8_t* data, size_t len) {
+        if (len >= 8 && len >= 8 + 2 * ((size_t)data[4] + data[5])) {
+            p = data;
+        }
+    }
+
+    bool valid() const { return p != nullptr; }
+    uint16_t hardwareType() const { return readBE16(p); }
+    uint16_t protocolType() const { return readBE16(p + 2); }
+    uint8_t hardwareLen() const { return p[4]; }
+    uint8_t protocolLen() const { return p[5]; }
+    uint16_t opcode() const { return readBE16(p + 6); }
+    const uint8_t* senderHardware() const { return p + 8; }
+    const uint8_t* senderProtocol() const { return p + 8 + hardwareLen(); }
+    const uint8_t* targetHardware() const { return p + 8 + hardwareLen() + protocolLen(); }
+    const uint8_t* targetProtocol() const { return p + 8 + 2 * hardwareLen() + protocolLen(); }
+
+    /**
+     * @brief ǷΪ̫ + IPv4 ĳʽַ 6 / 4
+     */
+    bool isEthernetIpv4() const {
+        return hardwareType() == 1 && protocolType() == ETH_TYPE_IPV4 && hardwareLen() == 6 && protocolLen() == 4;
+    }
+
+private:
+    const uint8_t* p = nullptr;
+};
+
+/**
+ * @brief IPv4 ײRFC 791
+ */
+class Ipv4View {
+public:
+    static const size_t MIN_SIZE = 20;
+
+    Ipv4View() = default;
+    Ipv4View(const uint8_t* data, size_t len) {
+        if (len >= MIN_SIZE && (data[0] >> 4) == 4 && (size_t)(data[0] & 0x0F) * 4 >= MIN_SIZE &&
+            (size_t)(data[0] & 0x0F) * 4 <= len) {
+            p = data;
+            n = len;
+        }
+    }
+
+    bool valid() const { return p != nullptr; }
+    size_t headerLen() const { return (size_t)(p[0] & 0x0F) * 4; }
+    uint8_t tos() const { return p[1]; }
+    uint16_t totalLength() const { return readBE16(p + 2); }
+    uint16_t id() const { return readBE16(p + 4); }
+    bool dontFragment() const { return (p[6] & 0x40) != 0; }
+    bool moreFragments() const { return (p[6] & 0x20) != 0; }
+    uint16_t fragmentOffset() const { return (uint16_t)(readBE16(p + 6) & 0x1FFF); } // 8ֽΪλ
+    uint8_t ttl() const { return p[8]; }
+    uint8_t protocol() const { return p[9]; }
+    uint16_t checksum() const { return readBE16(p + 10); }
+    const uint8_t* src() const { return p + 12; }
+    const uint8_t* dst() const { return p + 16; }
+    uint32_t srcAddr() const { return readBE32(p + 12); } // ֽ
+    uint32_t dstAddr() const { return readBE32(p + 16); }
+
+    /**
+     * @brief ǷΪƬƬַƬûϲЭײ
+     */
+    bool laterFragment() const { return fragmentOffset() != 0; }
+
+    /**
+     * @brief ϲݣܳȽȡܳȳʵʱʵΪ׼
+     */
+    const uint8_t* payload() const { return p + headerLen(); }
+    size_t payloadLen() const {
+        const size_t total = (totalLength() >= headerLen() && totalLength() <= n) ? totalLength() : n;
+        return total - headerLen();
+    }
+
+private:
+    const uint8_t* p = nullptr;
+    size_t n = 0;
+};
+
+/**
+ * @brief IPv6 ̶ײRFC 8200upperLayer() չײ
+ */
+class Ipv6View {
+public:
+    static const size_t SIZE = 40;
+
+    Ipv6View() = default;
+    Ipv6View(const uint8_t* data, size_t len) {
+        if (len >= SIZE && (data[0] >> 4) == 6) {
+            p = data;
+            n = len;
+        }
+    }
+
+    bool valid() const { return p != nullptr; }
+    uint8_t trafficClass() const { return (uint8_t)((readBE16(p) >> 4) & 0xFF); }
+    uint32_t flowLabel() const { return readBE32(p) & 0xFFFFF; }
+    uint16_t payloadLength() const { return readBE16(p + 4); }
+    uint8_t nextHeader() const { return p[6]; }
+    uint8_t hopLimit() const { return p[7]; }
+    const uint8_t* src() const { return p + 8; }
+    const uint8_t* dst() const { return p + 24; }
+
+    /**
+     * @brief ѡ·ɡĿѡƬչײҵϲЭ
+     * @param proto ϲЭţƬƬչײԽʱΪ 59 (No Next Header)
+     * @param len ϲݳ
+     * @return ϲʼλ
+     */
+    const uint8_t* upperLayer(uint8_t& proto, size_t& len) const {
+        const size_t end = (SIZE + payloadLength() <= n) ? SIZE + payloadLength() : n;
+        size_t pos = SIZE;
+        proto = nextHeader();
+        for (int i = 0; i < 8; ++i) {
+            if (proto != 0 && proto != 43 && proto != 60 && proto != 44) break;
+            if (pos + 8 > end) {
+                proto = 59;
+                break;
+            }
+            const uint8_t next = p[pos];
+            if (proto == 44) {
+                if ((readBE16(p + pos + 2) & 0xFFF8) != 0) { // ƬƬ
+                    proto = 59;
+                    break;
+                }
+                pos += 8;
+            }
+            else {
+                pos += ((size_t)p[pos + 1] + 1) * 8;
+            }
+            proto = next;
+        }
+        if (pos > end) {
+            proto = 59;
+            pos = end;
+        }
+        len = end - pos;
+        return p + pos;
+    }
+
+private:
+    const uint8_t* p = nullptr;
+    size_t n = 0;
+};
+
+/**
+ * @brief TCP ײRFC 9293
+ */
+class TcpView {
+public:
+    static const size_t MIN_SIZE = 20;
+
+    TcpView() = default;
+    TcpView(const uint8_t* data, size_t len) {
+        if (len >= MIN_SIZE && (size_t)(data[12] >> 4) * 4 >= MIN_SIZE && (size_t)(data[12] >> 4) * 4 <= len) {
+            p = data;
+            n = len;
+        }
+    }
+
+    bool valid() const { return p != nullptr; }
+    uint16_t srcPort() const { return readBE16(p); }
+    uint16_t dstPort() const { return readBE16(p + 2); }
+    uint32_t seq() const { return readBE32(p + 4); }
+    uint32_t ack() const { return readBE32(p + 8); }
+    size_t headerLen() const { return (size_t)(p[12] >> 4) * 4; }
+    uint16_t flags() const { return (uint16_t)(readBE16(p + 12) & 0x01FF); } // NS CWR ECE URG ACK PSH RST SYN FIN
+    uint16_t window() const { return readBE16(p + 14); }
+    uint16_t checksum() const { return readBE16(p + 16); }
+    const uint8_t* payload() const { return p + headerLen(); }
+    size_t payloadLen() const { return n - headerLen(); }
+
+private:
+    const uint8_t* p = nullptr;
+    size_t n = 0;
+};
+
+/**
+ * @brief UDP ײRFC 768
+ */
+class UdpView {
+public:
+    static const size_t SIZE = 8;
+
+    UdpView() = default;
+    UdpView(const uint8_t* data, size_t len) {
+        if (len >= SIZE) {
+            p = data;
+            n = len;
+        }
+    }
+
+    bool valid() const { return p != nullptr; }
+    uint16_t srcPort() const { return readBE16(p); }
+    uint16_t dstPort() const { return readBE16(p + 2); }
+    uint16_t length() const { return readBE16(p + 4); }
+    uint16_t checksum() const { return readBE16(p + 6); }
+    const uint8_t* payload() const { return p + SIZE; }
+    size_t payloadLen() const { return n - SIZE; }
+
+private:
+    const uint8_t* p = nullptr;
+    size_t n = 0;
+};
+
+/**
+ * @brief ICMP / ICMPv6 ײ
+ */
+class IcmpView {
+public:
+    static const size_t SIZE = 8;
+
+    IcmpView() = default;
+    IcmpView(const uint8_t* data, size_t len) : p(len >= SIZE ? data : nullptr) {
+    }
+
+    bool valid() const { return p != nullptr; }
+    uint8_t type() const { return p[0]; }
+    uint8_t code() const { return p[1]; }
+    uint16_t checksum() const { return readBE16(p + 2); }
+    uint16_t id() const { return readBE16(p + 4); }       //  / Ӧ
+    uint16_t sequence() const { return readBE16(p + 6); } //  / Ӧ
+
+private:
+    const uint8_t* p = nullptr;
+};
+
+/**
+ * @brief һֶ֡ʶЭ飻ڵĲӦͼ valid() Ϊ false
+ */
+struct PacketLayers {
+    static const int MAX_VLANS = 2;
+
+    VlanView vlans[MAX_VLANS];
+    int vlanCount = 0;
+    uint16_t etherType = 0; // ȥ VLAN ǩֶ
+    ArpView arp;
+    Ipv4View ipv4;
+    Ipv6View ipv6;
+    uint8_t ipProto = 0;    // ϲЭţû IP ʱΪ 0
+    TcpView tcp;
+    UdpView udp;
+    IcmpView icmp;
+
+    /**
+     * @brief Ƿʶֶ֮κһ
+     */
+    bool any() const {
+        return vlanCount > 0 || arp.valid() || ipv4.valid() || ipv6.valid();
+    }
+};
+
+/**
+ * @brief ֶ̫οʼʶVLAN ǩ  ARP / IPv4 / IPv6  TCP / UDP / ICMP
+ * @param etherType ̫֡ͷеֶ
+ * @param data ֶ
+ * @param len ֶγ
+ * @param out ͼ
+ */
+inline void decodeLayers(uint16_t etherType, const uint8_t* data, size_t len, PacketLayers& out) {
+    out = PacketLayers();
+    while ((etherType == ETH_TYPE_VLAN || etherType == ETH_TYPE_QINQ) && out.vlanCount < PacketLayers::MAX_VLANS) {
+        const VlanView tag(data, len);
+        if (!tag.valid()) break;
+        out.vlans[out.vlanCount++] = tag;
+        etherType = tag.etherType();
+        data += VlanView::SIZE;
+        len -= VlanView::SIZE;
+    }
+    out.etherType = etherType;
+
+    const uint8_t* l4 = nullptr;
+    size_t l4Len = 0;
+    if (etherType == ETH_TYPE_ARP) {
+        out.arp = ArpView(data, len);
+        return;
+    }
+    if (etherType == ETH_TYPE_IPV4) {
+        out.ipv4 = Ipv4View(data, len);
+        if (!out.ipv4.valid()) return;
+        out.ipProto = out.ipv4.protocol();
+        if (out.ipv4.laterFragment()) return;
+        l4 = out.ipv4.payload();
+        l4Len = out.ipv4.payloadLen();
+    }
+    else if (etherType == ETH_TYPE_IPV6) {
+        out.ipv6 = Ipv6View(data, len);
+        if (!out.ipv6.valid()) return;
+        l4 = out.ipv6.upperLayer(out.ipProto, l4Len);
+    }
+    else {
+        return;
+    }
+
+    // ICMP ֻ IPv4ICMPv6 ֻ IPv6Э㲻ʱ
+    const uint8_t icmpProto = out.ipv4.valid() ? IP_PROTO_ICMP : IP_PROTO_ICMPV6;
+    if (out.ipProto == IP_PROTO_TCP) {
+        out.tcp = TcpView(l4, l4Len);
+    }
+    else if (out.ipProto == IP_PROTO_UDP) {
+        out.udp = UdpView(l4, l4Len);
+    }
+    else if (out.ipProto == icmpProto) {
+        out.icmp = IcmpView(l4, l4Len);
+    }
+}
@@ -0,0 +1,356 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// ------------------ ı ------------------
+// ʽ׷ӵɸõַܹһһд
+// ֶι stringstream ˢ¡
+
+// ÿֽڶӦλʮַд / Сд
+static const char HEX_PAIRS_UPPER[] =
+    "000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+    "202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+    "404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+    "606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+    "808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+    "A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+    "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+    "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+static const char HEX_PAIRS_LOWER[] =
+    "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+    "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+    "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+    "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+    "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+    "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+// 0~99 Ӧλʮַ
+static const char DEC_PAIRS[] =
+    "0001020304050607080910111213141516171819202122232425262728293031"
+    "3233343536373839404142434445464748495051525354555657585960616263"
+    "6465666768697071727374757677787980818283848586878889909192939495"
+    "96979899";
+
+/**
+ * @brief  IPv4 ַʽΪ'\0'βĵʮַ sprintf("%d.%d.%d.%d")
+ * @param out λã16ֽ
+ * @param ip ֽ4ֽ
+ * @return дַ'\0'
+ */
+inline size_t formatIPv4(char* out, const uint8_t* ip) {
+    char* p = out;
+    for (int i = 0; i < 4; ++i) {
+        if (i) *p++ = '.';
+        unsigned int v = ip[i];
+        if (v >= 100) {
+            *p++ = (char)('0' + v / 100);
+            v %= 100;
+            *p++ = DEC_PAIRS[v * 2];
+            *p++ = DEC_PAIRS[v * 2 + 1];
+        }
+        else if (v >= 10) {
+            *p++ = DEC_PAIRS[v * 2];
+            *p++ = DEC_PAIRS[v * 2 + 1];
+        }
+        else {
+            *p++ = (char)('0' + v);
+        }
+    }
+    *p = '\0';
+    return (size_t)(p - out);
+}
+
+/**
+ * @brief ȫд׼ƹ iostream 壬÷豣֤ cout ˳
+ * @param data ָ
+ * @param len ݳ
+ */
+inline void writeStdout(const char* data, size_t len) {
+    while (len > 0) {
+#ifdef _WIN32
+        unsigned int chunk = len > 0x40000000 ? 0x40000000u : (unsigned int)len;
+        int n = _write(1, data, chunk);
+#else
+        ssize_t n = write(STDOUT_FILENO, data, len);
+#endif
+        if (n <= 0) {
+            return; // ѹرգܵһ˳ʣ
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+/**
+ * @brief ɸõı׷Ӳʱַ
+ */
+class TextBuffer {
+public:
+    // ﵽôСʱ flushIfFull дһ
+    static const size_t FLUSH_SIZE = 256 * 1024;
+
+    explicit TextBuffer(size_t capacity = FLUSH_SIZE + 4096) : buf(capacity) {
+    }
+
+    const char* data() const { return buf.data(); }
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+    void clear() { len = 0; }
+    std::string str() const { return std::string(buf.data(), len); }
+
+    TextBuffer& put(char c) {
+        *reserve(1) = c;
+        ++len;
+        return *this;
+    }
+
+    TextBuffer& put(const char* s, size_t n) {
+        memcpy(reserve(n), s, n);
+        len += n;
+        return *this;
+    }
+
+    TextBuffer& put(const char* s) {
+        return put(s, strlen(s));
+    }
+
+    TextBuffer& put(const std::string& s) {
+        return put(s.data(), s.size());
+    }
+
+    /**
+     * @brief ַ width ʱԿո루൱ left << setw(width)
+     */
+    TextBuffer& field(const char* s, size_t n, size_t width) {
+        put(s, n);
+        return n < width ? fill(' ', width - n) : *this;
+    }
+
+    TextBuffer& field(const std::string& s, size_t width) {
+        return field(s.data(), s.size(), width);
+    }
+
+    /**
+     * @brief ظ count ַ c
+     */
+    TextBuffer& fill(char c, size_t count) {
+        memset(reserve(count), c, count);
+        len += count;
+        return *this;
+    }
+
+    /**
+     * @brief һֽڵλʮ
+     */
+    TextBuffer& hex8(uint8_t b, bool upper = true) {
+        const char* pair = (upper ? HEX_PAIRS_UPPER : HEX_PAIRS_LOWER) + b * 2;
+        char* p = reserve(2);
+        p[0] = pair[0];
+        p[1] = pair[1];
+        len += 2;
+        return *this;
+    }
+
+    /**
+     * @brief ̶λʮƣλ0൱ hex << setw(digits) << setfill('0')
+     * @param v ֵ
+     * @param digits λ1~8ֵλʱȫЧλ
+     */
+    TextBuffer& hex(uint32_t v, int digits, bool upper = true) {
+        while (digits < 8 && (v >> (digits * 4)) != 0) ++digits;
+        const char* table = upper ? HEX_PAIRS_UPPER : HEX_PAIRS_LOWER;
+        char* p = reserve((size_t)digits);
+        for (int i = digits - 1; i >= 0; --i) {
+            p[i] = table[(v & 0xF) * 2 + 1];
+            v >>= 4;
+        }
+        len += (size_t)digits;
+        return *this;
+    }
+
+    /**
+     * @brief ʮ
+     */
+    TextBuffer& dec(uint64_t v) {
+        return dec(v, 0, ' ');
+    }
+
+    /**
+     * @brief Ҷʮ൱ setw(width) << setfill(padding)
+     */
+    TextBuffer& dec(uint64_t v, int width, char padding) {
+        char tmp[20];
+        char* end = tmp + sizeof(tmp);
+        char* p = end;
+        while (v >= 100) {
+            unsigned int r = (unsigned int)(v % 100);
+            v /= 100;
+            p -= 2;
+            p[0] = DEC_PAIRS[r * 2];
+            p[1] = DEC_PAIRS[r * 2 + 1];
+        }
+        if (v >= 10) {
+            p -= 2;
+            p[0] = DEC_PAIRS[v * 2];
+            p[1] = DEC_PAIRS[v * 2 + 1];
+        }
+        else {
+            *--p = (char)('0' + v);
+        }
+        size_t n = (size_t)(end - p);
+        if ((size_t)width > n) fill(padding, (size_t)width - n);
+        return put(p, n);
+    }
+
+    /**
+     * @brief зʮ
+     */
+    TextBuffer& sdec(int64_t v) {
+        if (v < 0) {
+            put('-');
+            return dec((uint64_t)0 - (uint64_t)v);
+        }
+        return dec((uint64_t)v);
+    }
+
+    /**
+     * @brief ԷָӵʮӲַ "XX-XX-XX-XX-XX-XX"
+     * @param addr ַֽ
+     * @param n ֽ
+     * @param sep ָ
+     * @param upper Ƿʹôд
+     */
+    TextBuffer& mac(const uint8_t* addr, size_t n = 6, char sep = '-', bool upper = true) {
+        for (size_t i = 0; i < n; ++i) {
+            if (i) put(sep);
+            hex8(addr[i], upper);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief ʮ IPv4 ַ
+     * @param ip ֽ4ֽ
+     */
+    TextBuffer& ipv4(const uint8_t* ip) {
+        len += formatIPv4(reserve(16), ip);
+        return *this;
+    }
+
+    /**
+     * @brief ʮ IPv4 ַ
+     * @param ip ֽĵַ
+     */
+    TextBuffer& ipv4(uint32_t ip) {
+        const uint8_t bytes[4] = { (uint8_t)(ip >> 24), (uint8_t)(ip >> 16), (uint8_t)(ip >> 8), (uint8_t)ip };
+        return ipv4(bytes);
+    }
+
+    /**
+     * @brief  RFC 5952  IPv6 ַʮСдʡǰ㣬һȫ飨飩д "::"
+     * @param ip ֽ16ֽ
+     */
+    TextBuffer& ipv6(const uint8_t* ip) {
+        uint16_t groups[8];
+        for (int i = 0; i < 8; ++i) {
+            groups[i] = (uint16_t)((ip[2 * i] << 8) | ip[2 * i + 1]);
+        }
+        int bestStart = -1, bestLen = 1;
+        for (int i = 0; i < 8;) {
+            int j = i;
+            while (j < 8 && groups[j] == 0) ++j;
+            if (j - i > bestLen) {
+                bestStart = i;
+                bestLen = j - i;
+            }
+            i = (j == i) ? i + 1 : j;
+        }
+        for (int i = 0; i < 8; ++i) {
+            if (i == bestStart) {
+                put("::");
+                i += bestLen - 1;
+                continue;
+            }
+            if (i > 0 && i != bestStart + bestLen) put(':');
+            hex(groups[i], 1, false); // λʱԶЧλ
+        }
+        return *this;
+    }
+
+    /**
+     * @brief С׷ĵ bytes ֽڣڶƼ¼
+     */
+    TextBuffer& le(uint64_t v, int bytes) {
+        char* p = reserve((size_t)bytes);
+        for (int i = 0; i < bytes; ++i) {
+            p[i] = (char)(v >> (i * 8));
+        }
+        len += (size_t)bytes;
+        return *this;
+    }
+
+    /**
+     * @brief ASCIIֽݣɴӡַʾΪ'.'
+     */
+    TextBuffer& ascii(const uint8_t* bytes, size_t n) {
+        char* p = reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            uint8_t c = bytes[i];
+            p[i] = (c >= 0x20 && c < 0x7F) ? (char)c : '.';
+        }
+        len += n;
+        return *this;
+    }
+
+    /**
+     * @brief дȫݵ׼
+     */
+    void flush() {
+        if (len > 0) {
+            writeStdout(buf.data(), len);
+            len = 0;
+        }
+    }
+
+    /**
+     * @brief ݴﵽ FLUSH_SIZE ʱд
+     */
+    void flushIfFull() {
+        if (len >= FLUSH_SIZE) flush();
+    }
+
+private:
+    /**
+     * @brief ȷ׷ n ֽڣдλ
+     */
+    char* reserve(size_t n) {
+        if (len + n > buf.size()) {
+            size_t cap = buf.size() * 2;
+            if (cap < len + n) cap = len + n;
+            buf.resize(cap);
+        }
+        return buf.data() + len;
+    }
+
+    std::vector<char> buf;
+    size_t len = 0;
+};
+
+/**
+ * @brief ǰ߳רõıͬһ߳ڷʹã·
+ */
+inline TextBuffer& threadTextBuffer() {
+    thread_local TextBuffer tb;
+    return tb;
+}
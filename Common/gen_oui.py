@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+由 IEEE 的 MA-L 登记表生成 OuiData.h：OUI 到厂商名称的最小完美哈希表（hash and displace）。
+
+用法: python3 gen_oui.py oui.txt|oui.csv [OuiData.h]
+
+登记表可从 https://standards-oui.ieee.org/oui/oui.txt 或 oui.csv 下载。
+查找只计算两次哈希、读一个种子与一个槽位，见 OuiTable.h；这里的哈希函数必须与其中的 ouiMix() 一致。
+"""
+
+import csv
+import os
+import re
+import sys
+import unicodedata
+
+SLOT_SLACK = 64     # 槽位数 = 条目数 + 条目数 / SLOT_SLACK，留少量空位让最后的桶容易放下
+BUCKET_SIZE = 4     # 平均每个桶的条目数
+MAX_SEED = 0xFFFF   # 种子以 uint16 保存
+EMPTY = 0x1000000   # 空槽位的 OUI，不是合法的 24 位值
+
+
+def mix(x):
+    """lowbias32，与 OuiTable.h 中的 ouiMix() 相同"""
+    x &= 0xFFFFFFFF
+    x ^= x >> 16
+    x = (x * 0x7FEB352D) & 0xFFFFFFFF
+    x ^= x >> 15
+    x = (x * 0x846CA68B) & 0xFFFFFFFF
+    x ^= x >> 16
+    return x
+
+
+def slot_of(oui, seed, slots):
+    return mix(oui + (seed + 1) * 0x9E3779B9) % slots
+
+
+def ascii_name(name):
+    """去掉重音等附加符号，只保留 ASCII，厂商名称的输出与控制台编码无关"""
+    name = unicodedata.normalize('NFKD', name)
+    name = ''.join(c for c in name if 0x20 <= ord(c) < 0x7F)
+    return ' '.join(name.split())
+
+
+def read_registry(path):
+    entries = {}
+    with open(path, encoding='utf-8', errors='replace') as f:
+        if path.lower().endswith('.csv'):
+            # Registry,Assignment,Organization Name,Organization Address
+            for row in csv.reader(f):
+                if len(row) >= 3 and re.fullmatch(r'[0-9A-Fa-f]{6}', row[1]):
+                    entries[int(row[1], 16)] = row[2]
+        else:
+            for line in f:
+                m = re.match(r'\s*([0-9A-F]{2})-([0-9A-F]{2})-([0-9A-F]{2})\s+\(hex\)\s+(.*)', line)
+                if m:
+                    entries[int(m.group(1) + m.group(2) + m.group(3), 16)] = m.group(4)
+    result = {}
+    for oui, name in entries.items():
+        name = ascii_name(name)
+        if name:
+            result[oui] = name
+    return result
+
+
+def build(entries):
+    """返回 (种子表, 槽位表)；槽位为 (oui, 名称) 或 None"""
+    n = len(entries)
+    slots = n + n // SLOT_SLACK + 1
+    buckets = max(1, n // BUCKET_SIZE)
+    groups = [[] for _ in range(buckets)]
+    for oui in entries:
+        groups[mix(oui) % buckets].append(oui)
+    seeds = [0] * buckets
+    table = [None] * slots
+    # 先放大的桶，空位越来越少时只剩单个条目的桶
+    for b in sorted(range(buckets), key=lambda i: -len(groups[i])):
+        keys = groups[b]
+        if not keys:
+            continue
+        for seed in range(MAX_SEED + 1):
+            pos = [slot_of(k, seed, slots) for k in keys]
+            if len(set(pos)) == len(pos) and all(table[p] is None for p in pos):
+                break
+        else:
+            sys.exit('无法为桶 %d 找到种子，请增大 SLOT_SLACK' % b)
+        seeds[b] = seed
+        for k, p in zip(keys, pos):
+            table[p] = (k, entries[k])
+    return seeds, table
+
+
+def c_string(s):
+    return '"' + s.replace('\\', '\\\\').replace('"', '\\"').replace('?', '\\?') + '"'
+
+
+def write_header(path, source, entries, seeds, table):
+    names = sorted(set(entries.values()))
+    if len(names) > 0xFFFF:
+        sys.exit('厂商名称超过 65535 个，名称编号需要更宽的类型')
+    index = {name: i for i, name in enumerate(names)}
+    out = []
+    out.append('#pragma once')
+    out.append('')
+    out.append('// 由 gen_oui.py 从 %s 生成（%d 个 OUI，%d 个厂商），不要手工修改。' % (os.path.basename(source), len(entries), len(names)))
+    out.append('// 只应由 OuiTable.h 包含。')
+    out.append('')
+    out.append('#include <cstdint>')
+    out.append('')
+    out.append('const uint32_t OUI_ENTRY_COUNT = %d;' % len(entries))
+    out.append('const uint32_t OUI_BUCKET_COUNT = %d;' % len(seeds))
+    out.append('const uint32_t OUI_SLOT_COUNT = %d;' % len(table))
+    out.append('const uint32_t OUI_EMPTY = 0x%X; // 空槽位' % EMPTY)
+    out.append('')
+    out.append('struct OuiSlot {')
+    out.append('    uint32_t oui;  // 24 位 OUI，空槽位为 OUI_EMPTY')
+    out.append('    uint16_t name; // 在 names 中的序号')
+    out.append('};')
+    out.append('')
+    out.append('// 类模板的静态成员可以定义在头文件中，多个编译单元包含时链接后只保留一份')
+    out.append('template <typename T = void>')
+    out.append('struct OuiData {')
+    out.append('    static constexpr uint16_t seeds[OUI_BUCKET_COUNT] = {')
+    for i in range(0, len(seeds), 16):
+        out.append('        ' + ','.join(str(s) for s in seeds[i:i + 16]) + ',')
+    out.append('    };')
+    out.append('    static constexpr OuiSlot slots[OUI_SLOT_COUNT] = {')
+    for i in range(0, len(table), 8):
+        row = []
+        for e in table[i:i + 8]:
+            row.append('{0x%06X,%d}' % (e[0], index[e[1]]) if e else '{0x%X,0}' % EMPTY)
+        out.append('        ' + ','.join(row) + ',')
+    out.append('    };')
+    out.append('    static constexpr const char* names[%d] = {' % len(names))
+    for name in names:
+        out.append('        ' + c_string(name) + ',')
+    out.append('    };')
+    out.append('};')
+    out.append('')
+    out.append('template <typename T> constexpr uint16_t OuiData<T>::seeds[OUI_BUCKET_COUNT];')
+    out.append('template <typename T> constexpr OuiSlot OuiData<T>::slots[OUI_SLOT_COUNT];')
+    out.append('template <typename T> constexpr const char* OuiData<T>::names[%d];' % len(names))
+    with open(path, 'w', encoding='gbk', newline='\n') as f:  # 与仓库中其他源文件一致
+        f.write('\n'.join(out) + '\n')
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit(__doc__)
+    source = sys.argv[1]
+    target = sys.argv[2] if len(sys.argv) > 2 else os.path.join(os.path.dirname(os.path.abspath(__file__)), 'OuiData.h')
+    entries = read_registry(source)
+    if not entries:
+        sys.exit('%s 中没有找到 OUI 条目' % source)
+    seeds, table = build(entries)
+    write_header(target, source, entries, seeds, table)
+    print('%s: %d 个 OUI，%d 个桶，%d 个槽位' % (target, len(entries), len(seeds), len(table)))
+
+
+if __name__ == '__main__':
+    main()
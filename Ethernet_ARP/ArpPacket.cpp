@@ -0,0 +1,112 @@
+#include "ArpPacket.h"
+
+#include <cctype>
+#include <cstring>
+
+using namespace std;
+
+bool ipv4_from_str(const char* s, uint32_t& ip) {
+    ip = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (!isdigit((unsigned char)*s)) return false;
+        unsigned int part = 0;
+        int digits = 0;
+        while (isdigit((unsigned char)*s) && digits < 4) {
+            part = part * 10 + (unsigned int)(*s++ - '0');
+            ++digits;
+        }
+        if (part > 255 || digits > 3) return false;
+        ip = (ip << 8) | part;
+        if (i < 3 && *s++ != '.') return false;
+    }
+    return *s == '\0';
+}
+
+namespace {
+
+/**
+ * @brief ģ幹һ֡
+ */
+vector<uint8_t> build_arp(uint16_t opcode, const uint8_t src_mac[6], uint32_t src_ip,
+                          const uint8_t dst_mac[6], const uint8_t target_mac[6], uint32_t target_ip) {
+    vector<uint8_t> buf(ARP_FRAME_TEMPLATE, ARP_FRAME_TEMPLATE + ARP_FRAME_LEN);
+    uint8_t* p = buf.data();
+    memcpy(p + ARP_OFF_DST_MAC, dst_mac, 6);
+    memcpy(p + 6, src_mac, 6);
+    p[ARP_OFF_OPCODE] = (uint8_t)(opcode >> 8);
+    p[ARP_OFF_OPCODE + 1] = (uint8_t)opcode;
+    memcpy(p + ARP_OFF_SENDER_MAC, src_mac, 6);
+    store_ipv4(p + ARP_OFF_SENDER_IP, src_ip);
+    memcpy(p + ARP_OFF_TARGET_MAC, target_mac, 6);
+    store_ipv4(p + ARP_OFF_TARGET_IP, target_ip);
+    return buf;
+}
+
+const uint8_t ZERO_MAC[6] = { 0, 0, 0, 0, 0, 0 };
+
+} // namespace
+
+vector<uint8_t> build_arp_request(const uint8_t src_mac[6], uint32_t src_ip,
+                                  const uint8_t dst_mac[6], uint32_t target_ip) {
+    return build_arp(ARP_OP_REQUEST, src_mac, src_ip, dst_mac, ZERO_MAC, target_ip);
+}
+
+vector<uint8_t> build_arp_reply(const uint8_t src_mac[6], uint32_t src_ip,
+                                const uint8_t dst_mac[6], uint32_t target_ip) {
+    return build_arp(ARP_OP_REPLY, src_mac, src_ip, dst_mac, dst_mac, target_ip);
+}
+
+// ------------------  ------------------
+
+ArpBatch::ArpBatch(size_t capacity) : storage(new uint8_t[(capacity + 1) * SLOT_SIZE]), cap(capacity) {
+    const uintptr_t base = (uintptr_t)storage.get();
+    slots = storage.get() + ((SLOT_SIZE - base % SLOT_SIZE) % SLOT_SIZE);
+    memset(proto, 0, sizeof(proto));
+}
+
+void ArpBatch::prepare(uint16_t opcode, const uint8_t src_mac[6], uint32_t src_ip, const uint8_t dst_mac[6]) {
+    memcpy(proto, ARP_FRAME_TEMPLATE, ARP_FRAME_LEN);
+    memcpy(proto + ARP_OFF_DST_MAC, dst_mac, 6);
+    memcpy(proto + 6, src_mac, 6);
+    proto[ARP_OFF_OPCODE] = (uint8_t)(opcode >> 8);
+    proto[ARP_OFF_OPCODE + 1] = (uint8_t)opcode;
+    memcpy(proto + ARP_OFF_SENDER_MAC, src_mac, 6);
+    store_ipv4(proto + ARP_OFF_SENDER_IP, src_ip);
+}
+
+size_t ArpBatch::build_requests(const uint8_t src_mac[6], uint32_t src_ip, const uint32_t* target_ips, size_t n) {
+    prepare(ARP_OP_REQUEST, src_mac, src_ip, BROADCAST_MAC);
+    count = n < cap ? n : cap;
+    uint8_t* p = slots;
+    for (size_t i = 0; i < count; ++i, p += SLOT_SIZE) {
+        // λƣչΪ洢
+        memcpy(p, proto, SLOT_SIZE);
+        store_ipv4(p + ARP_OFF_TARGET_IP, target_ips[i]);
+    }
+    return count;
+}
+
+size_t ArpBatch::build_sweep(const uint8_t src_mac[6], uint32_t src_ip, uint32_t first_ip, size_t n) {
+    prepare(ARP_OP_REQUEST, src_mac, src_ip, BROADCAST_MAC);
+    count = n < cap ? n : cap;
+    uint8_t* p = slots;
+    for (size_t i = 0; i < count; ++i, p += SLOT_SIZE) {
+        memcpy(p, proto, SLOT_SIZE);
+        store_ipv4(p + ARP_OFF_TARGET_IP, first_ip + (uint32_t)i);
+    }
+    return count;
+}
+
+size_t ArpBatch::build_replies(const uint8_t src_mac[6], uint32_t src_ip, const uint32_t* target_ips,
+                               const uint8_t (*target_macs)[6], size_t n) {
+    prepare(ARP_OP_REPLY, src_mac, src_ip, BROADCAST_MAC);
+    count = n < cap ? n : cap;
+    uint8_t* p = slots;
+    for (size_t i = 0; i < count; ++i, p += SLOT_SIZE) {
+        memcpy(p, proto, SLOT_SIZE);
+        memcpy(p + ARP_OFF_DST_MAC, target_macs[i], 6);
+        memcpy(p + ARP_OFF_TARGET_MAC, target_macs[i], 6);
+        store_ipv4(p + ARP_OFF_TARGET_IP, target_ips[i]);
+    }
+    return count;
+}
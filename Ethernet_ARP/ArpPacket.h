@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// ------------------ ARP ĸʽ ------------------
+
+// ֹṹ屻Զ䣬ΪЭֽڲϸ壬бԶֽ
+#pragma pack(push, 1)
+
+// ̫֡ͷ14ֽڣ
+struct EthHeader {
+    uint8_t dst_mac[6];
+    uint8_t src_mac[6];
+    uint16_t ethertype;
+};
+
+// ARP ͷ28ֽڣ
+struct ArpHeader {
+    uint16_t hw_type;      // Ӳͣ1 ʾ̫
+    uint16_t proto_type;   // Эͣ0x0800 ʾ IPv4
+    uint8_t hw_len;        // ӲַȣEthernet Ϊ 6
+    uint8_t proto_len;     // ЭַȣIPv4 Ϊ 4
+    uint16_t opcode;       // 룺1=, 2=Ӧ
+    uint8_t sender_mac[6];
+    uint8_t sender_ip[4];
+    uint8_t target_mac[6];
+    uint8_t target_ip[4];
+};
+
+#pragma pack(pop)
+
+const size_t ARP_FRAME_LEN = sizeof(EthHeader) + sizeof(ArpHeader); // 42ֽڣ FCS 
+const uint16_t ARP_OP_REQUEST = 1;
+const uint16_t ARP_OP_REPLY = 2;
+
+// ֶ֡еƫ
+const size_t ARP_OFF_DST_MAC = 0;
+const size_t ARP_OFF_OPCODE = sizeof(EthHeader) + 6;
+const size_t ARP_OFF_SENDER_MAC = sizeof(EthHeader) + 8;
+const size_t ARP_OFF_SENDER_IP = sizeof(EthHeader) + 14;
+const size_t ARP_OFF_TARGET_MAC = sizeof(EthHeader) + 18;
+const size_t ARP_OFF_TARGET_IP = sizeof(EthHeader) + 24;
+
+/**
+ * @brief ̫ + IPv4 ARP ֡Ĺ̶ַ֣ȫΪ0ʱ
+ */
+const uint8_t ARP_FRAME_TEMPLATE[ARP_FRAME_LEN] = {
+    0, 0, 0, 0, 0, 0,   // Ŀĵַ
+    0, 0, 0, 0, 0, 0,   // Դַ
+    0x08, 0x06,         // ֶΣARP
+    0x00, 0x01,         // Ӳ̫ͣ
+    0x08, 0x00,         // ЭͣIPv4
+    6, 4,               // Ӳ / Эַ
+    0x00, 0x00,         // 
+    0, 0, 0, 0, 0, 0,   // ͷ MAC
+    0, 0, 0, 0,         // ͷ IP
+    0, 0, 0, 0, 0, 0,   // Ŀ MAC
+    0, 0, 0, 0,         // Ŀ IP
+};
+
+const uint8_t BROADCAST_MAC[6] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+
+/**
+ * @brief ֽд IPv4 ַ
+ * @param p Ŀλ
+ * @param ip ֽĵַ
+ */
+inline void store_ipv4(uint8_t* p, uint32_t ip) {
+    p[0] = (uint8_t)(ip >> 24);
+    p[1] = (uint8_t)(ip >> 16);
+    p[2] = (uint8_t)(ip >> 8);
+    p[3] = (uint8_t)ip;
+}
+
+/**
+ * @brief ֽ IPv4 ַֽ
+ */
+inline uint32_t load_ipv4(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/**
+ * @brief ʮ IPv4 ַ
+ * @param s ַַ
+ * @param ip ֽĵַ
+ * @return ʽ󷵻 false
+ */
+bool ipv4_from_str(const char* s, uint32_t& ip);
+
+// 쵥 ARP Ŀ MAC Ϊȫ0
+std::vector<uint8_t> build_arp_request(const uint8_t src_mac[6], uint32_t src_ip,
+                                       const uint8_t dst_mac[6], uint32_t target_ip);
+
+// 쵥 ARP Ӧ
+std::vector<uint8_t> build_arp_reply(const uint8_t src_mac[6], uint32_t src_ip,
+                                     const uint8_t dst_mac[6], uint32_t target_ip);
+
+// ------------------  ------------------
+
+/**
+ * @brief һڴ ARP ֡
+ *
+ * ÿ֡ռһж 64 ֽڲλ42 ֽ֡ + 㣬ʱֱӲ㵽 60 ֽڵС֡
+ * һֶ֡ΣԴַͷַ룩һԭ֮ͣÿֻ֡ԭ
+ * дĿ IPӦĿ MACڴ桢ַ
+ * ڹʱȷ֮ظʹͬһڴ档
+ */
+class ArpBatch {
+public:
+    static const size_t SLOT_SIZE = 64;
+
+    /**
+     * @param capacity ɵ֡
+     */
+    explicit ArpBatch(size_t capacity);
+
+    /**
+     * @brief һ㲥滻ԭ
+     * @param src_mac  MAC
+     * @param src_ip  IPֽ
+     * @param target_ips Ҫѯ IPֽ
+     * @param n Ĳֱ
+     * @return ʵʹ֡
+     */
+    size_t build_requests(const uint8_t src_mac[6], uint32_t src_ip, const uint32_t* target_ips, size_t n);
+
+    /**
+     * @brief һַ first_ip, first_ip + 1, ... Ĺ㲥ɨʱʹã
+     */
+    size_t build_sweep(const uint8_t src_mac[6], uint32_t src_ip, uint32_t first_ip, size_t n);
+
+    /**
+     * @brief һӦ滻ԭ
+     * @param src_mac  MAC
+     * @param src_ip  IPӦеķͷַ
+     * @param target_ips  IP
+     * @param target_macs  MACͬʱΪ֡Ŀĵַ
+     * @param n 
+     * @return ʵʹ֡
+     */
+    size_t build_replies(const uint8_t src_mac[6], uint32_t src_ip, const uint32_t* target_ips,
+                         const uint8_t (*target_macs)[6], size_t n);
+
+    size_t capacity() const {
+        return cap;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    /**
+     * @brief  i ֡Ϊ ARP_FRAME_LEN㵽 SLOT_SIZE
+     */
+    const uint8_t* frame(size_t i) const {
+        return slots + i * SLOT_SIZE;
+    }
+
+    /**
+     * @brief ֡ڵڴ棬֡ SLOT_SIZE ֽ
+     */
+    const uint8_t* data() const {
+        return slots;
+    }
+
+private:
+    /**
+     * @brief ģһ֡Ĺֶͬдԭ
+     */
+    void prepare(uint16_t opcode, const uint8_t src_mac[6], uint32_t src_ip, const uint8_t dst_mac[6]);
+
+    std::unique_ptr<uint8_t[]> storage; // һλڶ
+    uint8_t* slots;                     // 뵽 SLOT_SIZE ĵһλ
+    size_t cap;
+    size_t count = 0;
+    alignas(16) uint8_t proto[SLOT_SIZE];
+};
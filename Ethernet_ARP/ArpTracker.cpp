@@ -0,0 +1,199 @@
+#include "ArpTracker.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+// ṹеĶֶֽαֽ򣬰ֽڶ
+inline uint16_t net16(const uint16_t& v) {
+    const uint8_t* b = (const uint8_t*)&v;
+    return (uint16_t)((b[0] << 8) | b[1]);
+}
+
+// λе MAC ȫ0ʾûյӦ
+inline bool mac_known(const uint8_t* mac) {
+    return (mac[0] | mac[1] | mac[2] | mac[3] | mac[4] | mac[5]) != 0;
+}
+
+} // namespace
+
+ArpParseResult parse_arp(const uint8_t* data, size_t len, ArpMessage& msg) {
+    if (len < ARP_FRAME_LEN) {
+        return ArpParseResult::TooShort;
+    }
+    // ƵṹУⰴδĵַ
+    EthHeader eth;
+    ArpHeader arp;
+    memcpy(&eth, data, sizeof(eth));
+    memcpy(&arp, data + sizeof(eth), sizeof(arp));
+
+    if (net16(eth.ethertype) != 0x0806) {
+        return ArpParseResult::NotArp;
+    }
+    if (net16(arp.hw_type) != 1 || net16(arp.proto_type) != 0x0800 || arp.hw_len != 6 || arp.proto_len != 4) {
+        return ArpParseResult::BadFormat;
+    }
+    msg.opcode = net16(arp.opcode);
+    if (msg.opcode != ARP_OP_REQUEST && msg.opcode != ARP_OP_REPLY) {
+        return ArpParseResult::BadOpcode;
+    }
+    static const uint8_t zero[6] = { 0, 0, 0, 0, 0, 0 };
+    if ((arp.sender_mac[0] & 0x01) != 0 || memcmp(arp.sender_mac, zero, 6) == 0) {
+        return ArpParseResult::BadSender;
+    }
+    memcpy(msg.eth_src, eth.src_mac, 6);
+    memcpy(msg.eth_dst, eth.dst_mac, 6);
+    memcpy(msg.sender_mac, arp.sender_mac, 6);
+    memcpy(msg.target_mac, arp.target_mac, 6);
+    msg.sender_ip = load_ipv4(arp.sender_ip);
+    msg.target_ip = load_ipv4(arp.target_ip);
+    return ArpParseResult::Ok;
+}
+
+const char* arp_parse_result_name(ArpParseResult r) {
+    switch (r) {
+    case ArpParseResult::Ok:        return "";
+    case ArpParseResult::TooShort:  return "Ȳ";
+    case ArpParseResult::NotArp:    return " ARP";
+    case ArpParseResult::BadFormat: return "̫/IPv4 ʽ";
+    case ArpParseResult::BadOpcode: return "Ч";
+    default:                        return "ͷ MAC Ч";
+    }
+}
+
+// ------------------ ӦĶӦ ------------------
+
+ArpTracker::ArpTracker(size_t expected) {
+    size_t cap = 16;
+    while (cap < expected * 2) cap *= 2;
+    slots.assign(cap, Slot());
+    mask = cap - 1;
+}
+
+size_t ArpTracker::find(uint32_t ip) const {
+    size_t i = hash(ip) & mask;
+    while (slots[i].state != EMPTY && slots[i].ip != ip) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+void ArpTracker::erase(size_t index) {
+    // ̽ɾѺ̽ϵĿǰƣĹ
+    size_t hole = index;
+    size_t i = index;
+    for (;;) {
+        i = (i + 1) & mask;
+        if (slots[i].state == EMPTY) break;
+        const size_t home = hash(slots[i].ip) & mask;
+        // home  (hole, i] ʱĿƵλ
+        const bool between = (hole <= i) ? (home > hole && home <= i) : (home > hole || home <= i);
+        if (!between) {
+            slots[hole] = slots[i];
+            hole = i;
+        }
+    }
+    slots[hole].state = EMPTY;
+    --used;
+}
+
+void ArpTracker::grow() {
+    vector<Slot> old;
+    old.swap(slots);
+    slots.assign(old.size() * 2, Slot());
+    mask = slots.size() - 1;
+    for (const Slot& s : old) {
+        if (s.state != EMPTY) slots[find(s.ip)] = s;
+    }
+}
+
+void ArpTracker::on_request(uint32_t target_ip, uint64_t now_ns) {
+    if ((used + 1) * 2 > slots.size()) {
+        grow();
+    }
+    Slot& s = slots[find(target_ip)];
+    if (s.state == EMPTY) {
+        s.ip = target_ip;
+        s.state = PENDING;
+        memset(s.mac, 0, 6);
+        ++used;
+        ++pending;
+    }
+    else if (s.state == ANSWERED) {
+        // Ӧĵַٴβѯ¼ʱ֮ǰ MAC ڳͻ
+        s.state = PENDING;
+        ++pending;
+    }
+    s.sent_ns = now_ns;
+    order.push_back(SentRecord{ target_ip, now_ns });
+}
+
+ArpReplyResult ArpTracker::on_reply(const ArpMessage& msg, uint64_t now_ns) {
+    ArpReplyResult r;
+    r.latency_ns = 0;
+    memset(r.previous_mac, 0, 6);
+
+    const size_t i = find(msg.sender_ip);
+    Slot& s = slots[i];
+    if (s.state == EMPTY) {
+        r.kind = ArpReplyKind::Unsolicited;
+        return r;
+    }
+    if (s.state == PENDING) {
+        r.latency_ns = now_ns > s.sent_ns ? now_ns - s.sent_ns : 0;
+        if (!mac_known(s.mac)) {
+            r.kind = ArpReplyKind::Answered;
+            memcpy(s.mac, msg.sender_mac, 6);
+        }
+        else if (memcmp(s.mac, msg.sender_mac, 6) != 0) {
+            // ²ѯʱ MAC ӦһһӦ MACֻͻ
+            // αĺӦ𲻻ᶥ
+            r.kind = ArpReplyKind::Conflict;
+            memcpy(r.previous_mac, s.mac, 6);
+        }
+        else {
+            r.kind = ArpReplyKind::Answered;
+        }
+        s.state = ANSWERED;
+        --pending;
+        return r;
+    }
+    if (memcmp(s.mac, msg.sender_mac, 6) == 0) {
+        r.kind = ArpReplyKind::Duplicate;
+    }
+    else {
+        // һӦ MAC֮ÿͬӦ𶼱Ϊͻ
+        r.kind = ArpReplyKind::Conflict;
+        memcpy(r.previous_mac, s.mac, 6);
+    }
+    return r;
+}
+
+size_t ArpTracker::expire(uint64_t now_ns, uint64_t timeout_ns, vector<uint32_t>& unanswered) {
+    size_t n = 0;
+    while (!order.empty() && order.front().sent_ns + timeout_ns <= now_ns) {
+        const SentRecord rec = order.front();
+        order.pop_front();
+        const size_t i = find(rec.ip);
+        // ֻһη͵ļ¼ЧӦ֮ط
+        if (slots[i].state != PENDING || slots[i].sent_ns != rec.sent_ns) {
+            continue;
+        }
+        unanswered.push_back(rec.ip);
+        --pending;
+        erase(i);
+        ++n;
+    }
+    return n;
+}
+
+bool ArpTracker::lookup(uint32_t ip, uint8_t mac[6]) const {
+    const Slot& s = slots[find(ip)];
+    if (s.state == EMPTY || !mac_known(s.mac)) {
+        return false;
+    }
+    memcpy(mac, s.mac, 6);
+    return true;
+}
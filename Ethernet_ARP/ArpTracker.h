@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "ArpPacket.h"
+
+// ------------------ ARP Ľ ------------------
+
+/**
+ * @brief 
+ */
+enum class ArpParseResult {
+    Ok,
+    TooShort,    //  42 ֽ
+    NotArp,      // ֶβ 0x0806
+    BadFormat,   // ̫ + IPv4 ʽӲ / ЭͻַȲ
+    BadOpcode,   // ȲҲӦ
+    BadSender,   // ͷ MAC Ϊ鲥 / 㲥ȫ0
+};
+
+/**
+ * @brief  ARP ģַΪֽ
+ */
+struct ArpMessage {
+    uint16_t opcode;
+    uint8_t eth_src[6];
+    uint8_t eth_dst[6];
+    uint8_t sender_mac[6];
+    uint32_t sender_ip;
+    uint8_t target_mac[6];
+    uint32_t target_ip;
+
+    /**
+     * @brief  ARPͷĿ IP ַͬͻ
+     */
+    bool gratuitous() const {
+        return sender_ip == target_ip;
+    }
+};
+
+/**
+ * @brief  EthHeader / ArpHeader ĲֽУһ֡
+ * @param data Ŀĵַʼ֡
+ * @param len ݳ
+ * @param msg ֻڷ Ok ʱЧ
+ */
+ArpParseResult parse_arp(const uint8_t* data, size_t len, ArpMessage& msg);
+
+const char* arp_parse_result_name(ArpParseResult r);
+
+// ------------------ ӦĶӦ ------------------
+
+/**
+ * @brief һӦδյĽ
+ */
+enum class ArpReplyKind {
+    Answered,    // һӦlatency_ns ΪӦʱ
+    Duplicate,   // ͬһ MAC ظӦ
+    Conflict,    // ֮ǰӦ MAC ͬIP ַͻ
+    Unsolicited, // ûжӦ
+};
+
+struct ArpReplyResult {
+    ArpReplyKind kind;
+    uint64_t latency_ns;     // Answered ʱЧ
+    uint8_t previous_mac[6]; // Conflict ʱΪ֮ǰӦ MAC
+};
+
+/**
+ * @brief Ŀ IP Ϊδ
+ *
+ * Ѱַ̽⣩ϣΪ 2 ݣسһʱӱÿλ
+ * һķʱһӦ MACӦĿڱУʶ
+ * ظӦ IP ͻ˳򱣴һУʱֻף
+ * Ŀ޹ءʱΪ룬ɵ÷ṩͬһʱµֵ
+ * ̰߳ȫ
+ */
+class ArpTracker {
+public:
+    /**
+     * @param expected ԤͬʱڵĿȷʼ
+     */
+    explicit ArpTracker(size_t expected = 1024);
+
+    /**
+     * @brief ¼󣻶ͬһ IP طʱ·ʱ
+     */
+    void on_request(uint32_t target_ip, uint64_t now_ns);
+
+    /**
+     * @brief һӦ
+     * @param msg Ӧ𣨻 ARP
+     * @param now_ns յӦʱ
+     */
+    ArpReplyResult on_reply(const ArpMessage& msg, uint64_t now_ns);
+
+    /**
+     * @brief ȡͳ timeout_ns δӦЩĿӱɾ
+     * @param now_ns ǰʱ
+     * @param timeout_ns ʱʱ
+     * @param unanswered ׷ӳʱĿ IP
+     * @return γʱĿ
+     */
+    size_t expire(uint64_t now_ns, uint64_t timeout_ns, std::vector<uint32_t>& unanswered);
+
+    /**
+     * @brief δӦҲδʱ
+     */
+    size_t outstanding() const {
+        return pending;
+    }
+
+    /**
+     * @brief еĿӦ
+     */
+    size_t size() const {
+        return used;
+    }
+
+    /**
+     * @brief ѯӦ IP Ӧ MAC
+     * @return ûӦʱ false
+     */
+    bool lookup(uint32_t ip, uint8_t mac[6]) const;
+
+private:
+    enum : uint8_t { EMPTY = 0, PENDING = 1, ANSWERED = 2 };
+
+    struct Slot {
+        uint32_t ip;
+        uint8_t state;
+        uint8_t mac[6];
+        uint64_t sent_ns; // һķʱ
+    };
+
+    struct SentRecord {
+        uint32_t ip;
+        uint64_t sent_ns;
+    };
+
+    static uint32_t hash(uint32_t ip) {
+        // ˷ɢУַҲܷɢ
+        return (uint32_t)((ip * 0x9E3779B1u) ^ (ip >> 16));
+    }
+
+    size_t find(uint32_t ip) const;
+    void erase(size_t index);
+    void grow();
+
+    std::vector<Slot> slots;
+    size_t mask;
+    size_t used = 0;
+    size_t pending = 0;
+    std::deque<SentRecord> order; // ʱУܺӦطľɼ¼
+};
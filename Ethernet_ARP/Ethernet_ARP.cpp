@@ -1,35 +1,20 @@
 #include <iostream>
 #include <iomanip>
 #include <vector>
+#include <string>
+#include <chrono>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
-#include <winsock2.h>
-#pragma comment(lib, "ws2_32.lib")
+#include <memory>
+#include <array>
+#include <algorithm>
+#include <csignal>
 
-// ֹṹ屻Զ䣬ΪЭֽڲϸ壬бԶֽ
-#pragma pack(push, 1)
-
-// ̫֡ͷ14ֽڣ
-struct EthHeader {
-    uint8_t dst_mac[6];
-    uint8_t src_mac[6];
-    uint16_t ethertype;
-};
-
-// ARP ͷ28ֽڣ
-struct ArpHeader {
-    uint16_t hw_type;      // Ӳͣ1 ʾ̫
-    uint16_t proto_type;   // Эͣ0x0800 ʾ IPv4
-    uint8_t hw_len;        // ӲַȣEthernet Ϊ 6
-    uint8_t proto_len;     // ЭַȣIPv4 Ϊ 4
-    uint16_t opcode;       // 룺1=, 2=Ӧ
-    uint8_t sender_mac[6];
-    uint8_t sender_ip[4];
-    uint8_t target_mac[6];
-    uint8_t target_ip[4];
-};
-
-#pragma pack(pop)
+#include "ArpPacket.h"
+#include "RawLink.h"
+#include "ArpTracker.h"
+#include "../Common/BenchTimer.h"
 
 // ʽ
 void print_hex(const std::vector<uint8_t>& buf) {
@@ -41,105 +26,336 @@ void print_hex(const std::vector<uint8_t>& buf) {
     std::cout << std::dec << std::endl;
 }
 
-// ַIPת4ֽ
-void ipv4_from_str(const char* s, uint8_t out[4]) {
-    unsigned int a, b, c, d;
-    sscanf_s(s, "%u.%u.%u.%u", &a, &b, &c, &d);
-    out[0] = (uint8_t)a;
-    out[1] = (uint8_t)b;
-    out[2] = (uint8_t)c;
-    out[3] = (uint8_t)d;
+// ------------------ ܲ ------------------
+
+void print_rate(const char* name, double seconds, size_t packets) {
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(10) << seconds * 1000 << " ms"
+              << std::setw(10) << seconds * 1e9 / (double)packets << " ns/"
+              << std::setw(14) << std::setprecision(0) << (double)packets / seconds << " /s  "
+              << name << std::endl;
 }
 
-//  ARP 
-std::vector<uint8_t> build_arp_request(
-    const uint8_t src_mac[6],
-    const char* src_ip_str,
-    const uint8_t dst_mac_broadcast[6],
-    const char* target_ip_str
-) {
-    std::vector<uint8_t> buf(sizeof(EthHeader) + sizeof(ArpHeader));
-    EthHeader eth{};
-    ArpHeader arp{};
-
-    // Ethernet ͷ
-    memcpy(eth.dst_mac, dst_mac_broadcast, 6);
-    memcpy(eth.src_mac, src_mac, 6);
-    eth.ethertype = htons(0x0806); // ARP
-
-    // ARP ͷ
-    arp.hw_type = htons(1);         // Ethernet
-    arp.proto_type = htons(0x0800); // IPv4
-    arp.hw_len = 6;
-    arp.proto_len = 4;
-    arp.opcode = htons(1);          // request
-
-    memcpy(arp.sender_mac, src_mac, 6);
-    ipv4_from_str(src_ip_str, arp.sender_ip);
-    memset(arp.target_mac, 0x00, 6);
-    ipv4_from_str(target_ip_str, arp.target_ip);
-
-    size_t offset = 0;
-    memcpy(buf.data() + offset, &eth, sizeof(eth));
-    offset += sizeof(eth);
-    memcpy(buf.data() + offset, &arp, sizeof(arp));
-
-    return buf;
+// Ƚһ /16 ȫٶ
+int run_benchmark(unsigned int rounds) {
+    const uint8_t my_mac[6] = { 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc };
+    const uint8_t other_mac[6] = { 0x66, 0x55, 0x44, 0x33, 0x22, 0x11 };
+    const uint32_t my_ip = 0xC0A80A0A;   // 192.168.10.10
+    const uint32_t first_ip = 0xC0A80000; // 192.168.0.0/16
+    const size_t count = 65536;
+
+    std::vector<uint32_t> targets(count);
+    std::unique_ptr<uint8_t[][6]> macs(new uint8_t[count][6]);
+    for (size_t i = 0; i < count; ++i) {
+        targets[i] = first_ip + (uint32_t)i;
+        memcpy(macs[i], other_mac, 6);
+        macs[i][5] = (uint8_t)i;
+    }
+    ArpBatch batch(count);
+
+    std::cout << " " << count << "  ARP , " << rounds << " ȡһ" << std::endl;
+    print_rate(" (ÿһ vector)", bestOf(rounds, [&]() {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < count; ++i) {
+            acc += build_arp_request(my_mac, my_ip, BROADCAST_MAC, targets[i])[41];
+        }
+        benchSink(acc);
+    }), count);
+    print_rate(" (Ŀб)", bestOf(rounds, [&]() {
+        batch.build_requests(my_mac, my_ip, targets.data(), count);
+        benchSink(batch.frame(count - 1)[41]);
+    }), count);
+    print_rate(" (ַ)", bestOf(rounds, [&]() {
+        batch.build_sweep(my_mac, my_ip, first_ip, count);
+        benchSink(batch.frame(count - 1)[41]);
+    }), count);
+    print_rate("Ӧ", bestOf(rounds, [&]() {
+        batch.build_replies(my_mac, my_ip, targets.data(), macs.get(), count);
+        benchSink(batch.frame(count - 1)[41]);
+    }), count);
+    print_rate("Ӧ", bestOf(rounds, [&]() {
+        ArpTracker tracker(count);
+        for (size_t i = 0; i < count; ++i) {
+            tracker.on_request(targets[i], 1);
+        }
+        uint64_t acc = 0;
+        for (size_t i = 0; i < count; ++i) {
+            ArpMessage msg;
+            if (parse_arp(batch.frame(i), ARP_FRAME_LEN, msg) == ArpParseResult::Ok) {
+                msg.sender_ip = msg.target_ip; // ӦԱѯĵַ
+                acc += tracker.on_reply(msg, 2).latency_ns;
+            }
+        }
+        benchSink(acc + tracker.outstanding());
+    }), count);
+    return 0;
 }
 
-//  ARP Ӧ
-std::vector<uint8_t> build_arp_reply(
-    const uint8_t src_mac[6],
-    const char* src_ip_str,
-    const uint8_t dst_mac[6],
-    const char* target_ip_str
-) {
-    std::vector<uint8_t> buf(sizeof(EthHeader) + sizeof(ArpHeader));
-    EthHeader eth{};
-    ArpHeader arp{};
-
-    memcpy(eth.dst_mac, dst_mac, 6);
-    memcpy(eth.src_mac, src_mac, 6);
-    eth.ethertype = htons(0x0806);
-
-    arp.hw_type = htons(1);
-    arp.proto_type = htons(0x0800);
-    arp.hw_len = 6;
-    arp.proto_len = 4;
-    arp.opcode = htons(2);
-
-    memcpy(arp.sender_mac, src_mac, 6);
-    ipv4_from_str(src_ip_str, arp.sender_ip);
-
-    memcpy(arp.target_mac, dst_mac, 6);
-    ipv4_from_str(target_ip_str, arp.target_ip);
-
-    size_t offset = 0;
-    memcpy(buf.data() + offset, &eth, sizeof(eth));
-    offset += sizeof(eth);
-    memcpy(buf.data() + offset, &arp, sizeof(arp));
-
-    return buf;
+// ------------------ շ ------------------
+
+// Ctrl+C Ӧģʽ
+volatile sig_atomic_t respond_stopped = 0;
+
+void on_interrupt(int) {
+    respond_stopped = 1;
 }
 
-int main() {
-    WSADATA wsa;
-    WSAStartup(MAKEWORD(2, 2), &wsa);
+void print_mac(const uint8_t* mac) {
+    std::cout << std::hex << std::setfill('0');
+    for (int i = 0; i < 6; ++i) {
+        std::cout << (i ? "-" : "") << std::setw(2) << (int)mac[i];
+    }
+    std::cout << std::dec << std::setfill(' ');
+}
+
+void print_ip(uint32_t ip) {
+    std::cout << (ip >> 24) << '.' << ((ip >> 16) & 0xFF) << '.' << ((ip >> 8) & 0xFF) << '.' << (ip & 0xFF);
+}
+
+//  "a.b.c.d/n"εĵһַַ
+bool parse_cidr(const char* s, uint32_t& first, uint64_t& count) {
+    const char* slash = strchr(s, '/');
+    if (!slash) return false;
+    const std::string addr(s, slash);
+    char* end = nullptr;
+    const long prefix = strtol(slash + 1, &end, 10);
+    uint32_t ip = 0;
+    if (*end != '\0' || end == slash + 1 || prefix < 0 || prefix > 32 || !ipv4_from_str(addr.c_str(), ip)) {
+        return false;
+    }
+    const uint32_t mask = prefix == 0 ? 0 : 0xFFFFFFFFu << (32 - prefix);
+    first = ip & mask;
+    count = (uint64_t)1 << (32 - prefix);
+    return true;
+}
+
+// ǰʱ䣨룬ں˸֡ʱͬһʱӣ
+uint64_t wall_clock_ns() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// һɨĽ
+struct SweepResult {
+    struct Host {
+        uint32_t ip;
+        uint8_t mac[6];
+        uint64_t latency_ns;
+    };
+    std::vector<Host> hosts;
+    std::vector<std::pair<Host, std::array<uint8_t, 6>>> conflicts; // ͻӦ֮ǰӦ MAC
+    std::vector<uint32_t> unanswered;
+    uint64_t duplicates = 0;
+    uint64_t unsolicited = 0;
+    uint64_t invalid = 0;
+};
+
+// ȡ RX ѵ֡δɵ
+void collect_replies(RawLink& link, ArpTracker& tracker, SweepResult& result, int timeout_ms) {
+    static std::vector<RxFrame> frames;
+    // һȴ timeout_ms֮ѾĿȫȡ꣬ⷢڼ RX 
+    for (int wait = timeout_ms; link.receive(frames, wait) > 0; wait = 0) {
+        for (const RxFrame& f : frames) {
+            ArpMessage msg;
+            if (parse_arp(f.data, f.len, msg) != ArpParseResult::Ok) {
+                ++result.invalid;
+                continue;
+            }
+            if (msg.opcode != ARP_OP_REPLY) {
+                continue;
+            }
+            const ArpReplyResult r = tracker.on_reply(msg, (uint64_t)f.tsSec * 1000000000u + f.tsNsec);
+            SweepResult::Host host{ msg.sender_ip, {}, r.latency_ns };
+            memcpy(host.mac, msg.sender_mac, 6);
+            switch (r.kind) {
+            case ArpReplyKind::Answered:
+                result.hosts.push_back(host);
+                break;
+            case ArpReplyKind::Conflict: {
+                std::array<uint8_t, 6> previous;
+                memcpy(previous.data(), r.previous_mac, 6);
+                result.conflicts.emplace_back(host, previous);
+                break;
+            }
+            case ArpReplyKind::Duplicate:
+                ++result.duplicates;
+                break;
+            default:
+                ++result.unsolicited;
+                break;
+            }
+        }
+    }
+}
+
+// ÿַ㲥 ARP ռӦͳӦʱ
+int run_sweep(const char* ifname, const char* src_ip_str, const char* cidr, int wait_ms) {
+    uint32_t src_ip = 0, first = 0;
+    uint64_t count = 0;
+    if (!ipv4_from_str(src_ip_str, src_ip) || !parse_cidr(cidr, first, count)) {
+        std::cerr << "ַʽ: " << src_ip_str << " " << cidr << std::endl;
+        return 1;
+    }
+    RawLink link;
+    if (!link.open(ifname)) {
+        std::cerr << link.error() << std::endl;
+        return 1;
+    }
+
+    // ÿһ֡ TX һϵͳ÷֮ȡѵӦ
+    ArpTracker tracker((size_t)std::min<uint64_t>(count, 65536));
+    SweepResult result;
+    const uint64_t timeout_ns = (uint64_t)wait_ms * 1000000;
+    ArpBatch batch(4096);
+    uint64_t sent = 0;
+    const auto start = std::chrono::steady_clock::now();
+    while (sent < count) {
+        const size_t n = (size_t)std::min<uint64_t>(count - sent, batch.capacity());
+        batch.build_sweep(link.mac(), src_ip, first + (uint32_t)sent, n);
+        const uint64_t now = wall_clock_ns();
+        for (size_t i = 0; i < n; ++i) {
+            tracker.on_request(first + (uint32_t)(sent + i), now);
+        }
+        const size_t queued = link.send(batch);
+        sent += queued;
+        if (queued < n) {
+            std::cerr << link.error() << std::endl;
+            break;
+        }
+        collect_replies(link, tracker, result, 0);
+        tracker.expire(wall_clock_ns(), timeout_ns, result.unanswered);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // ȴʣӦ𣬳ʱΪδӦ
+    while (tracker.outstanding() > 0) {
+        collect_replies(link, tracker, result, 10);
+        tracker.expire(wall_clock_ns(), timeout_ns, result.unanswered);
+    }
+    // ٶһʱ䣬ԷֳٵظͻӦ
+    const uint64_t linger_end = wall_clock_ns() + timeout_ns / 4;
+    while (wall_clock_ns() < linger_end) {
+        collect_replies(link, tracker, result, 10);
+    }
+
+    uint64_t min_ns = 0, max_ns = 0, sum_ns = 0;
+    for (const SweepResult::Host& h : result.hosts) {
+        print_ip(h.ip);
+        std::cout << "  ";
+        print_mac(h.mac);
+        std::cout << "  " << std::fixed << std::setprecision(1) << (double)h.latency_ns / 1000 << " us" << std::endl;
+        if (min_ns == 0 || h.latency_ns < min_ns) min_ns = h.latency_ns;
+        if (h.latency_ns > max_ns) max_ns = h.latency_ns;
+        sum_ns += h.latency_ns;
+    }
+    for (const auto& c : result.conflicts) {
+        std::cout << "ַͻ: ";
+        print_ip(c.first.ip);
+        std::cout << "  ";
+        print_mac(c.second.data());
+        std::cout << " / ";
+        print_mac(c.first.mac);
+        std::cout << std::endl;
+    }
+
+    uint64_t packets = 0, drops = 0;
+    link.rxStats(packets, drops);
+    std::cerr << std::fixed << std::setprecision(3)
+              << " " << sent << " , ʱ " << seconds * 1000 << " ms ("
+              << std::setprecision(0) << (seconds > 0 ? (double)sent / seconds : 0) << " /s, "
+              << (link.txRing() ? "TX " : "sendmmsg") << ")" << std::endl;
+    std::cerr << "Ӧ " << result.hosts.size() << ", δӦ " << result.unanswered.size()
+              << ", ظ " << result.duplicates << ", ͻ " << result.conflicts.size()
+              << ", ޶Ӧ " << result.unsolicited << ", ʽ " << result.invalid;
+    if (!result.hosts.empty()) {
+        std::cerr << std::setprecision(1) << "; Ӧʱ С " << (double)min_ns / 1000
+                  << " us, ƽ " << (double)sum_ns / result.hosts.size() / 1000 << " us,  " << (double)max_ns / 1000 << " us";
+    }
+    if (drops > 0) std::cerr << "; RX  " << drops << " ֡";
+    std::cerr << std::endl;
+    return 0;
+}
+
+// յÿ ARP Աӿڵ MAC ӦģһеַߵΣ veth ԣ
+int run_responder(const char* ifname) {
+    RawLink link;
+    RawLinkOptions options;
+    options.rxBlockTimeoutMs = 1; // 󾡿콻û̬Ӧĸӳ
+    if (!link.open(ifname, options)) {
+        std::cerr << link.error() << std::endl;
+        return 1;
+    }
+    signal(SIGINT, on_interrupt);
+    signal(SIGTERM, on_interrupt);
+
+    std::vector<RxFrame> frames;
+    std::vector<uint8_t> out;
+    uint64_t answered = 0;
+    while (!respond_stopped) {
+        if (link.receive(frames, 100) == 0) continue;
+        // һеȫдΪӦһη
+        out.assign(frames.size() * ArpBatch::SLOT_SIZE, 0);
+        size_t n = 0;
+        for (const RxFrame& f : frames) {
+            ArpMessage msg;
+            if (parse_arp(f.data, f.len, msg) != ArpParseResult::Ok || msg.opcode != ARP_OP_REQUEST) {
+                continue;
+            }
+            uint8_t* p = out.data() + n++ * ArpBatch::SLOT_SIZE;
+            memcpy(p, ARP_FRAME_TEMPLATE, ARP_FRAME_LEN);
+            memcpy(p + ARP_OFF_DST_MAC, msg.sender_mac, 6);
+            memcpy(p + 6, link.mac(), 6);
+            p[ARP_OFF_OPCODE + 1] = ARP_OP_REPLY;
+            memcpy(p + ARP_OFF_SENDER_MAC, link.mac(), 6);
+            store_ipv4(p + ARP_OFF_SENDER_IP, msg.target_ip);
+            memcpy(p + ARP_OFF_TARGET_MAC, msg.sender_mac, 6);
+            store_ipv4(p + ARP_OFF_TARGET_IP, msg.sender_ip);
+        }
+        answered += link.send(out.data(), ArpBatch::SLOT_SIZE, ARP_FRAME_LEN, n);
+    }
+    std::cerr << "Ӧ " << answered << " " << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        const std::string arg = argv[1];
+        if (arg == "--bench" || arg.compare(0, 8, "--bench=") == 0) {
+            const long n = (arg.size() > 8) ? strtol(arg.c_str() + 8, nullptr, 10) : 5;
+            if (n > 0) {
+                return run_benchmark((unsigned int)n);
+            }
+        }
+        else if (arg == "--sweep" && (argc == 5 || argc == 6)) {
+            return run_sweep(argv[2], argv[3], argv[4], argc == 6 ? atoi(argv[5]) : 1000);
+        }
+        else if (arg == "--respond" && argc == 3) {
+            return run_responder(argv[2]);
+        }
+        std::cerr << "÷: " << argv[0] << " [--bench[=N] | --sweep ӿ IP /ǰ׺ [ȴms] | --respond ӿ]" << std::endl;
+        std::cerr << "  ʱ첢ӡһ ARP һӦ" << std::endl;
+        std::cerr << "  --bench[=N] ٶȣÿظ N ֣Ĭ 5" << std::endl;
+        std::cerr << "  --sweep      AF_PACKET TX ÿַ㲥ӦĵַӦʱ䣬" << std::endl;
+        std::cerr << "              Լȴ ms δӦظӦ IP ͻ Linux" << std::endl;
+        std::cerr << "  --respond   Աӿ MAC Ӧյ veth ϲԣ Linux" << std::endl;
+        return 1;
+    }
 
     uint8_t my_mac[6] = { 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc };
-    uint8_t broadcast_mac[6] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
     uint8_t other_mac[6] = { 0x66, 0x55, 0x44, 0x33, 0x22, 0x11 };
+    uint32_t ip_10 = 0, ip_100 = 0;
+    ipv4_from_str("192.168.1.10", ip_10);
+    ipv4_from_str("192.168.1.100", ip_100);
 
     // 192.168.1.10  192.168.1.100 ѯ
-    auto request = build_arp_request(my_mac, "192.168.1.10", broadcast_mac, "192.168.1.100");
+    auto request = build_arp_request(my_mac, ip_10, BROADCAST_MAC, ip_100);
     std::cout << "ARP Request (" << request.size() << " bytes):";
     print_hex(request);
 
     // Ӧ192.168.1.100  192.168.1.10 MAC
-    auto reply = build_arp_reply(my_mac, "192.168.1.100", other_mac, "192.168.1.10");
+    auto reply = build_arp_reply(my_mac, ip_100, other_mac, ip_10);
     std::cout << "\nARP Reply (" << reply.size() << " bytes):";
     print_hex(reply);
 
-    WSACleanup();
     return 0;
 }
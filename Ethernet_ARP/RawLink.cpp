@@ -0,0 +1,376 @@
+#include "RawLink.h"
+#include "ArpPacket.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <linux/if_packet.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+const size_t ETH_MIN_FRAME = 60;  // ̫С֡ FCS
+const size_t TX_FRAME_SIZE = 128; // TX ÿۣ֡ͷ 32 ֽ + ֡
+const size_t SENDMMSG_BATCH = 64;
+
+} // namespace
+
+RawLink::~RawLink() {
+    close();
+}
+
+bool RawLink::fail(const string& what) {
+    err = what;
+#ifdef __linux__
+    if (errno != 0) {
+        err += ": ";
+        err += strerror(errno);
+    }
+#endif
+    close();
+    return false;
+}
+
+size_t RawLink::send(const ArpBatch& batch) {
+    return send(batch.data(), ArpBatch::SLOT_SIZE, ARP_FRAME_LEN, batch.size());
+}
+
+#ifdef __linux__
+
+bool RawLink::open(const char* ifname, const RawLinkOptions& options) {
+    close();
+    err.clear();
+    errno = 0;
+    ifindex = (int)if_nametoindex(ifname);
+    if (ifindex == 0) {
+        return fail(string("Ҳӿ ") + ifname);
+    }
+
+    // ЭΪ 0 ׽ bind ֮ǰκ֡ͻٰ֮
+    txFd = socket(AF_PACKET, SOCK_RAW, 0);
+    rxFd = socket(AF_PACKET, SOCK_RAW, 0);
+    if (txFd < 0 || rxFd < 0) {
+        return fail("޷ AF_PACKET ׽֣Ҫ root  CAP_NET_RAW");
+    }
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+    if (ioctl(txFd, SIOCGIFHWADDR, &ifr) < 0) {
+        return fail(string("޷ȡӿ MAC ַ: ") + ifname);
+    }
+    memcpy(hwaddr, ifr.ifr_hwaddr.sa_data, 6);
+
+    if (!setupTx(options) || !setupRx(options)) {
+        return false;
+    }
+    return true;
+}
+
+void RawLink::close() {
+    if (txMap) munmap(txMap, txMapSize);
+    if (rxMap) munmap(rxMap, rxMapSize);
+    if (txFd >= 0) ::close(txFd);
+    if (rxFd >= 0) ::close(rxFd);
+    txMap = rxMap = nullptr;
+    txFd = rxFd = -1;
+    txHead = txPending = 0;
+    rxBlock = 0;
+    rxHeld = false;
+}
+
+// ------------------  ------------------
+
+bool RawLink::setupTx(const RawLinkOptions& o) {
+    struct sockaddr_ll addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sll_family = AF_PACKET;
+    addr.sll_protocol = 0; // ֻͣ
+    addr.sll_ifindex = ifindex;
+
+    // ƹŶӹֱӽں˲֧ʱ
+    int one = 1;
+    setsockopt(txFd, SOL_PACKET, PACKET_QDISC_BYPASS, &one, sizeof(one));
+
+    int version = TPACKET_V2;
+    const size_t perBlock = (size_t)getpagesize() / TX_FRAME_SIZE;
+    const size_t frames = (o.txFrames + perBlock - 1) / perBlock * perBlock;
+    struct tpacket_req req;
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = (unsigned int)getpagesize();
+    req.tp_block_nr = (unsigned int)(frames / perBlock);
+    req.tp_frame_size = (unsigned int)TX_FRAME_SIZE;
+    req.tp_frame_nr = (unsigned int)frames;
+    if (frames > 0 &&
+        setsockopt(txFd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) == 0 &&
+        setsockopt(txFd, SOL_PACKET, PACKET_TX_RING, &req, sizeof(req)) == 0) {
+        void* map = mmap(nullptr, frames * TX_FRAME_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, txFd, 0);
+        if (map != MAP_FAILED) {
+            txMap = (uint8_t*)map;
+            txMapSize = frames * TX_FRAME_SIZE;
+            txFrameSize = TX_FRAME_SIZE;
+            txFrameCount = frames;
+        }
+    }
+    // û TX ʱ sendmmsg ͣͬҪ󶨽ӿ
+    errno = 0;
+    if (bind(txFd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        return fail("޷󶨷׽");
+    }
+    return true;
+}
+
+bool RawLink::flushTx() {
+    if (txPending == 0) {
+        return true;
+    }
+    // һϵͳ÷д͵֡
+    if (::send(txFd, nullptr, 0, 0) < 0 && errno != EAGAIN && errno != ENOBUFS) {
+        err = string("ʧ: ") + strerror(errno);
+        return false;
+    }
+    txPending = 0;
+    return true;
+}
+
+size_t RawLink::send(const uint8_t* frames, size_t stride, size_t len, size_t n) {
+    if (txFd < 0 || len > TX_FRAME_SIZE - TPACKET_ALIGN(sizeof(struct tpacket2_hdr))) {
+        return 0;
+    }
+    if (!txMap) {
+        return sendBatchMsg(frames, stride, len, n);
+    }
+
+    const size_t dataOffset = TPACKET_ALIGN(sizeof(struct tpacket2_hdr));
+    const size_t wireLen = len < ETH_MIN_FRAME ? ETH_MIN_FRAME : len;
+    for (size_t i = 0; i < n; ++i) {
+        struct tpacket2_hdr* hdr = (struct tpacket2_hdr*)(txMap + txHead * txFrameSize);
+        // λԱںռãȴͣٵȴں˹黹λ
+        while (__atomic_load_n(&hdr->tp_status, __ATOMIC_ACQUIRE) & (TP_STATUS_SEND_REQUEST | TP_STATUS_SENDING)) {
+            if (!flushTx()) {
+                return i;
+            }
+            struct pollfd pfd = { txFd, POLLOUT, 0 };
+            poll(&pfd, 1, 1);
+        }
+        uint8_t* data = (uint8_t*)hdr + dataOffset;
+        memcpy(data, frames + i * stride, len);
+        if (wireLen > len) {
+            memset(data + len, 0, wireLen - len);
+        }
+        hdr->tp_len = (unsigned int)wireLen;
+        __atomic_store_n(&hdr->tp_status, TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+        txHead = (txHead + 1 == txFrameCount) ? 0 : txHead + 1;
+        ++txPending;
+    }
+    return flushTx() ? n : 0;
+}
+
+size_t RawLink::sendBatchMsg(const uint8_t* frames, size_t stride, size_t len, size_t n) {
+    struct sockaddr_ll dest;
+    memset(&dest, 0, sizeof(dest));
+    dest.sll_family = AF_PACKET;
+    dest.sll_ifindex = ifindex;
+    dest.sll_halen = 6;
+
+    uint8_t pad[SENDMMSG_BATCH][ETH_MIN_FRAME];
+    struct iovec iov[SENDMMSG_BATCH];
+    struct mmsghdr msgs[SENDMMSG_BATCH];
+    size_t sent = 0;
+    while (sent < n) {
+        const size_t count = (n - sent < SENDMMSG_BATCH) ? n - sent : SENDMMSG_BATCH;
+        for (size_t i = 0; i < count; ++i) {
+            const uint8_t* f = frames + (sent + i) * stride;
+            if (len < ETH_MIN_FRAME) {
+                memcpy(pad[i], f, len);
+                memset(pad[i] + len, 0, ETH_MIN_FRAME - len);
+                iov[i].iov_base = pad[i];
+                iov[i].iov_len = ETH_MIN_FRAME;
+            }
+            else {
+                iov[i].iov_base = (void*)f;
+                iov[i].iov_len = len;
+            }
+            memset(&msgs[i], 0, sizeof(msgs[i]));
+            msgs[i].msg_hdr.msg_name = &dest;
+            msgs[i].msg_hdr.msg_namelen = sizeof(dest);
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        const int r = sendmmsg(txFd, msgs, (unsigned int)count, 0);
+        if (r < 0) {
+            if (errno == ENOBUFS || errno == EAGAIN) {
+                struct pollfd pfd = { txFd, POLLOUT, 0 };
+                poll(&pfd, 1, 1);
+                continue;
+            }
+            err = string("ʧ: ") + strerror(errno);
+            break;
+        }
+        sent += (size_t)r;
+    }
+    return sent;
+}
+
+// ------------------  ------------------
+
+bool RawLink::setupRx(const RawLinkOptions& o) {
+    if (o.arpOnly) {
+        // ldh [12]; jeq #0x0806, , 
+        static struct sock_filter code[] = {
+            { 0x28, 0, 0, 12 },
+            { 0x15, 0, 1, 0x0806 },
+            { 0x06, 0, 0, 0x00040000 },
+            { 0x06, 0, 0, 0 },
+        };
+        struct sock_fprog prog = { (unsigned short)(sizeof(code) / sizeof(code[0])), code };
+        if (setsockopt(rxFd, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) < 0) {
+            return fail("޷ BPF ");
+        }
+    }
+#ifdef PACKET_IGNORE_OUTGOING
+    // ձ֡ں˲֧ʱ
+    int one = 1;
+    setsockopt(rxFd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &one, sizeof(one));
+#endif
+
+    int version = TPACKET_V3;
+    if (setsockopt(rxFd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+        return fail("ں˲֧ TPACKET_V3");
+    }
+    struct tpacket_req3 req;
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = (unsigned int)o.rxBlockSize;
+    req.tp_block_nr = (unsigned int)o.rxBlocks;
+    req.tp_frame_size = 2048;
+    req.tp_frame_nr = (unsigned int)(o.rxBlockSize / 2048 * o.rxBlocks);
+    req.tp_retire_blk_tov = (unsigned int)o.rxBlockTimeoutMs;
+    if (setsockopt(rxFd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+        return fail("޷ RX ");
+    }
+    rxMapSize = o.rxBlockSize * o.rxBlocks;
+    void* map = mmap(nullptr, rxMapSize, PROT_READ | PROT_WRITE, MAP_SHARED, rxFd, 0);
+    if (map == MAP_FAILED) {
+        return fail("޷ӳ RX ");
+    }
+    rxMap = (uint8_t*)map;
+    rxBlockSize = o.rxBlockSize;
+    rxBlockCount = o.rxBlocks;
+
+    struct sockaddr_ll addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sll_family = AF_PACKET;
+    addr.sll_protocol = htons(ETH_P_ALL);
+    addr.sll_ifindex = ifindex;
+    if (bind(rxFd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        return fail("޷󶨽׽");
+    }
+    return true;
+}
+
+void RawLink::releaseBlock() {
+    if (!rxHeld) {
+        return;
+    }
+    struct tpacket_block_desc* desc = (struct tpacket_block_desc*)(rxMap + rxBlock * rxBlockSize);
+    __atomic_store_n(&desc->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+    rxBlock = (rxBlock + 1 == rxBlockCount) ? 0 : rxBlock + 1;
+    rxHeld = false;
+}
+
+size_t RawLink::receive(vector<RxFrame>& out, int timeoutMs) {
+    out.clear();
+    if (!rxMap) {
+        return 0;
+    }
+    releaseBlock();
+
+    struct tpacket_block_desc* desc = (struct tpacket_block_desc*)(rxMap + rxBlock * rxBlockSize);
+    if (!(__atomic_load_n(&desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+        if (timeoutMs == 0) {
+            return 0;
+        }
+        struct pollfd pfd = { rxFd, POLLIN | POLLERR, 0 };
+        poll(&pfd, 1, timeoutMs);
+        if (!(__atomic_load_n(&desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+            return 0;
+        }
+    }
+
+    rxHeld = true;
+    const uint32_t count = desc->hdr.bh1.num_pkts;
+    const struct tpacket3_hdr* ppd = (const struct tpacket3_hdr*)((uint8_t*)desc + desc->hdr.bh1.offset_to_first_pkt);
+    for (uint32_t i = 0; i < count; ++i) {
+        out.push_back(RxFrame{ (const uint8_t*)ppd + ppd->tp_mac, ppd->tp_snaplen, ppd->tp_sec, ppd->tp_nsec });
+        ppd = (const struct tpacket3_hdr*)((const uint8_t*)ppd + ppd->tp_next_offset);
+    }
+    return out.size();
+}
+
+size_t RawLink::waitAny(RawLink* const* links, size_t n, int timeoutMs) {
+    vector<struct pollfd> fds;
+    fds.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        if (links[i]->rxFd >= 0) {
+            fds.push_back(pollfd{ links[i]->rxFd, POLLIN | POLLERR, 0 });
+        }
+    }
+    if (fds.empty()) {
+        return 0;
+    }
+    const int ready = poll(fds.data(), (nfds_t)fds.size(), timeoutMs);
+    return ready > 0 ? (size_t)ready : 0;
+}
+
+bool RawLink::rxStats(uint64_t& packets, uint64_t& drops) {
+    struct tpacket_stats_v3 st;
+    socklen_t len = sizeof(st);
+    if (rxFd < 0 || getsockopt(rxFd, SOL_PACKET, PACKET_STATISTICS, &st, &len) < 0) {
+        return false;
+    }
+    packets = st.tp_packets;
+    drops = st.tp_drops;
+    return true;
+}
+
+#else // ƽ̨û AF_PACKET
+
+bool RawLink::open(const char* ifname, const RawLinkOptions&) {
+    (void)ifname;
+    err = "ԭʼ·շ֧ Linux (AF_PACKET)";
+    return false;
+}
+
+void RawLink::close() {
+}
+
+size_t RawLink::send(const uint8_t*, size_t, size_t, size_t) {
+    return 0;
+}
+
+size_t RawLink::receive(vector<RxFrame>& out, int) {
+    out.clear();
+    return 0;
+}
+
+size_t RawLink::waitAny(RawLink* const*, size_t, int) {
+    return 0;
+}
+
+bool RawLink::rxStats(uint64_t&, uint64_t&) {
+    return false;
+}
+
+#endif
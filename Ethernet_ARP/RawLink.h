@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ArpBatch;
+
+// ------------------ ԭʼ·շ ------------------
+// Linux » AF_PACKET ׽ PACKET_MMAP λ
+//   ͣ֡дں˹ TX  (TPACKET_V2)һֻ֡һ send() 
+//         ں˲֧ TX ʱ˻ sendmmsgÿϵͳ÷Ͷ֡
+//   գں˰ RX  (TPACKET_V3)׽Ϲ BPF ֶֻΪ 0x0806 ֡뻷
+//         һ poll() ȡһеȫ֡
+// Ҫ root  CAP_NET_RAWƽ̨ open()  false
+//
+// ռ veth Բԣ
+//   ip netns add arp-peer
+//   ip link add arp0 type veth peer name arp1
+//   ip link set arp1 netns arp-peer
+//   ip link set arp0 up && ip netns exec arp-peer ip link set arp1 up
+//   ip netns exec arp-peer ./Ethernet_ARP --respond arp1 &
+//   ./Ethernet_ARP --sweep arp0 10.0.0.1 10.0.0.0/16
+
+/**
+ * @brief շĴС
+ */
+struct RawLinkOptions {
+    size_t txFrames = 4096;          // TX Ĳλÿ 128 ֽ
+    size_t rxBlockSize = 256 * 1024; // RX ÿֽ
+    size_t rxBlocks = 16;            // RX 
+    int rxBlockTimeoutMs = 10;       // δĿȴýû̬
+    bool arpOnly = true;             // նǷֻ ARP  BPF 
+};
+
+/**
+ * @brief RX еһָָ֡ڴ棬һ receive() ǰЧ
+ */
+struct RxFrame {
+    const uint8_t* data; // Ŀĵַʼ
+    size_t len;
+    uint32_t tsSec;      // ںյ֡ʱ
+    uint32_t tsNsec;
+};
+
+/**
+ * @brief 󶨵һӿڵԭʼ̫֡շ
+ *
+ * send()  receive() ֱʹøԵ׽֣߳ͬʱã
+ * ͬһɶ߳ͬʱá
+ */
+class RawLink {
+public:
+    RawLink() = default;
+    ~RawLink();
+    RawLink(const RawLink&) = delete;
+    RawLink& operator=(const RawLink&) = delete;
+
+    /**
+     * @brief 򿪽ӿڲշ
+     * @param ifname ӿ eth0
+     * @param options ĴС
+     * @return ʧܷ falseԭ error()
+     */
+    bool open(const char* ifname, const RawLinkOptions& options = RawLinkOptions());
+
+    void close();
+
+    const std::string& error() const {
+        return err;
+    }
+
+    /**
+     * @brief ӿڵ MAC ַ
+     */
+    const uint8_t* mac() const {
+        return hwaddr;
+    }
+
+    /**
+     * @brief Ƿʹ TX ͣΪ sendmmsg
+     */
+    bool txRing() const {
+        return txMap != nullptr;
+    }
+
+    /**
+     * @brief һȳ֡ 60 ֽڵ֡㵽̫С֡
+     * @param frames һ֡
+     * @param stride ֡ļ
+     * @param len ÿ֡ȣ FCS
+     * @param n ֡
+     * @return ں˵֡ʱС n
+     */
+    size_t send(const uint8_t* frames, size_t stride, size_t len, size_t n);
+
+    /**
+     * @brief һ ARP ֡
+     */
+    size_t send(const ArpBatch& batch);
+
+    /**
+     * @brief ȡյ֡
+     * @param out ȡ֮֡ǰȡ֡黹ں
+     * @param timeoutMs ûʱȴĺ0 ʾȴ
+     * @return ֡
+     */
+    size_t receive(std::vector<RxFrame>& out, int timeoutMs);
+
+    /**
+     * @brief ȴӿһ֡ȡ֮Ըӿڵ receive(out, 0) ȡ
+     * @param links ӿ
+     * @param n ӿ
+     * @param timeoutMs ȴĺ
+     * @return ֡ȡĽӿʱΪ 0
+     */
+    static size_t waitAny(RawLink* const* links, size_t n, int timeoutMs);
+
+    /**
+     * @brief ںͳƵĽ֡ RX ֡ϴε
+     */
+    bool rxStats(uint64_t& packets, uint64_t& drops);
+
+private:
+    bool fail(const std::string& what);
+    bool setupTx(const RawLinkOptions& o);
+    bool setupRx(const RawLinkOptions& o);
+    bool flushTx();
+    size_t sendBatchMsg(const uint8_t* frames, size_t stride, size_t len, size_t n);
+    void releaseBlock();
+
+    std::string err;
+    int ifindex = 0;
+    uint8_t hwaddr[6] = { 0, 0, 0, 0, 0, 0 };
+
+    int txFd = -1;
+    uint8_t* txMap = nullptr;
+    size_t txMapSize = 0;
+    size_t txFrameSize = 0;
+    size_t txFrameCount = 0;
+    size_t txHead = 0;    // һҪдĲλ
+    size_t txPending = 0; // д뵫δ send() ֡
+
+    int rxFd = -1;
+    uint8_t* rxMap = nullptr;
+    size_t rxMapSize = 0;
+    size_t rxBlockSize = 0;
+    size_t rxBlockCount = 0;
+    size_t rxBlock = 0;   // һҪȡĿ
+    bool rxHeld = false;  // ǰǷû̬
+};
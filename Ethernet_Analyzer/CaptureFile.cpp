@@ -0,0 +1,302 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "CaptureFile.h"
+
+using namespace std;
+
+namespace {
+
+const uint32_t PCAP_MAGIC_US = 0xA1B2C3D4; // ΢ʱ
+const uint32_t PCAP_MAGIC_NS = 0xA1B23C4D; // ʱ
+const size_t PCAP_HEADER_LEN = 24;
+const size_t PCAP_RECORD_LEN = 16;
+
+const uint32_t PCAPNG_SHB = 0x0A0D0D0A;       // ͷ飨ģֽ޹أ
+const uint32_t PCAPNG_IDB = 1;                // ӿ
+const uint32_t PCAPNG_PB = 2;                 // ɰݰ
+const uint32_t PCAPNG_SPB = 3;                // ݰ
+const uint32_t PCAPNG_EPB = 6;                // ǿݰ
+const uint32_t PCAPNG_BYTE_ORDER = 0x1A2B3C4D;
+const uint16_t PCAPNG_OPT_TSRESOL = 9;
+const uint16_t PCAPNG_OPT_FCSLEN = 13;
+
+const uint32_t LINKTYPE_ETHERNET = 1;
+const uint32_t WRITE_SNAPLEN = 262144;
+
+// ¼ / ĳޣΪļ
+const uint32_t MAX_RECORD_LEN = 64 * 1024 * 1024;
+
+inline uint32_t le32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline uint32_t be32(const unsigned char* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+inline uint16_t rd16(const unsigned char* p, bool big) {
+    return big ? (uint16_t)((p[0] << 8) | p[1]) : (uint16_t)(p[0] | (p[1] << 8));
+}
+
+inline uint32_t rd32(const unsigned char* p, bool big) {
+    return big ? be32(p) : le32(p);
+}
+
+/**
+ * @brief  pcapng ѡвһѡ
+ * @param opt ѡʼ
+ * @param len ѡ
+ * @param big ǷΪ
+ * @param code ѡ
+ * @param valueLen ѡֵ
+ * @return ѡֵλãδҵ nullptr
+ */
+const unsigned char* findOption(const unsigned char* opt, size_t len, bool big, uint16_t code, size_t& valueLen) {
+    size_t pos = 0;
+    while (pos + 4 <= len) {
+        uint16_t c = rd16(opt + pos, big);
+        size_t n = rd16(opt + pos + 2, big);
+        if (c == 0 || pos + 4 + n > len) {
+            break; // opt_endofopt ѡԽ
+        }
+        if (c == code) {
+            valueLen = n;
+            return opt + pos + 4;
+        }
+        pos += 4 + ((n + 3) & ~(size_t)3);
+    }
+    return nullptr;
+}
+
+} // namespace
+
+CaptureInfo probeCapture(const unsigned char* data, size_t size) {
+    CaptureInfo info;
+    if (size < 4) {
+        return info;
+    }
+    const uint32_t le = le32(data);
+    const uint32_t be = be32(data);
+    if (le == PCAP_MAGIC_US || le == PCAP_MAGIC_NS || be == PCAP_MAGIC_US || be == PCAP_MAGIC_NS) {
+        info.format = CaptureFormat::Pcap;
+        if (size >= PCAP_HEADER_LEN) {
+            // ·ֶεĸ4λF λ1ʱ3λΪ FCS ȣ16λΪλ
+            const uint32_t linkType = rd32(data + 20, le != PCAP_MAGIC_US && le != PCAP_MAGIC_NS);
+            if (linkType & 0x10000000) {
+                info.fcsLen = (int)((linkType >> 29) & 7) * 2;
+            }
+        }
+    }
+    else if (le == PCAPNG_SHB) {
+        info.format = CaptureFormat::Pcapng;
+        if (size < 12) {
+            return info;
+        }
+        const bool big = le32(data + 8) != PCAPNG_BYTE_ORDER;
+        const size_t shbLen = rd32(data + 4, big);
+        // ͷͨǵһӿ飬жȡ if_fcslen
+        if (shbLen >= 12 && shbLen + 16 <= size && rd32(data + shbLen, big) == PCAPNG_IDB) {
+            const unsigned char* idb = data + shbLen;
+            const size_t idbLen = rd32(idb + 4, big);
+            if (idbLen >= 20 && shbLen + idbLen <= size) {
+                size_t n = 0;
+                const unsigned char* v = findOption(idb + 16, idbLen - 20, big, PCAPNG_OPT_FCSLEN, n);
+                if (v && n >= 1) {
+                    info.fcsLen = v[0];
+                }
+            }
+        }
+    }
+    return info;
+}
+
+// ------------------ ¼ȡ ------------------
+
+CaptureReader::CaptureReader(CaptureFormat fmt) : fileFormat(fmt) {
+}
+
+uint16_t CaptureReader::rd16(const unsigned char* p) const {
+    return ::rd16(p, bigEndian);
+}
+
+uint32_t CaptureReader::rd32(const unsigned char* p) const {
+    return ::rd32(p, bigEndian);
+}
+
+size_t CaptureReader::fail(const char* msg, size_t size) {
+    if (err.empty()) {
+        err = msg;
+    }
+    return size; // ʣ
+}
+
+size_t CaptureReader::split(const unsigned char* data, size_t size, size_t from, bool atEnd, vector<FrameSpan>& spans) {
+    if (!err.empty()) {
+        return size;
+    }
+    return fileFormat == CaptureFormat::Pcapng
+        ? splitPcapng(data, size, from, atEnd, spans)
+        : splitPcap(data, size, from, atEnd, spans);
+}
+
+size_t CaptureReader::splitPcap(const unsigned char* data, size_t size, size_t from, bool atEnd, vector<FrameSpan>& spans) {
+    if (!headerDone) {
+        if (size - from < PCAP_HEADER_LEN) {
+            return atEnd ? fail("pcap ļͷ", size) : from;
+        }
+        const uint32_t magic = le32(data + from);
+        bigEndian = magic != PCAP_MAGIC_US && magic != PCAP_MAGIC_NS;
+        nanosecond = rd32(data + from) == PCAP_MAGIC_NS;
+        if ((rd32(data + from + 20) & 0xFFFF) != LINKTYPE_ETHERNET) {
+            return fail("ֵ֧·ֻ̫ͣܽ (LINKTYPE_ETHERNET) ץ", size);
+        }
+        headerDone = true;
+        from += PCAP_HEADER_LEN;
+    }
+
+    while (size - from >= PCAP_RECORD_LEN) {
+        const unsigned char* rec = data + from;
+        const uint32_t capLen = rd32(rec + 8);
+        if (capLen > MAX_RECORD_LEN) {
+            return fail("pcap ¼Чļ", size);
+        }
+        if (size - from - PCAP_RECORD_LEN < capLen) {
+            break; // ¼δ
+        }
+        const uint32_t frac = rd32(rec + 4);
+        FrameSpan span{ from + PCAP_RECORD_LEN, from + PCAP_RECORD_LEN + capLen };
+        span.tsSec = rd32(rec);
+        span.tsUsec = nanosecond ? frac / 1000 : frac;
+        spans.push_back(span);
+        from += PCAP_RECORD_LEN + capLen;
+    }
+    if (atEnd && from < size) {
+        return fail("ļĩβ pcap ¼", size);
+    }
+    return from;
+}
+
+size_t CaptureReader::splitPcapng(const unsigned char* data, size_t size, size_t from, bool atEnd, vector<FrameSpan>& spans) {
+    while (size - from >= 12) {
+        const unsigned char* blk = data + from;
+        const uint32_t type = le32(blk) == PCAPNG_SHB ? PCAPNG_SHB : rd32(blk);
+        if (type == PCAPNG_SHB) {
+            // ÿڿвֽͬɽͷеֽħ
+            const uint32_t order = le32(blk + 8);
+            if (order == PCAPNG_BYTE_ORDER) bigEndian = false;
+            else if (be32(blk + 8) == PCAPNG_BYTE_ORDER) bigEndian = true;
+            else return fail("pcapng ͷֽЧ", size);
+        }
+        const uint32_t len = rd32(blk + 4);
+        if (len < 12 || (len & 3) != 0 || len > MAX_RECORD_LEN) {
+            return fail("pcapng 鳤Чļ", size);
+        }
+        if (size - from < len) {
+            break; // δ
+        }
+        const unsigned char* body = blk + 8;
+        const size_t bodyLen = len - 12;
+
+        switch (type) {
+        case PCAPNG_SHB:
+            interfaces.clear(); // ӿڱÿ¿ʼ
+            break;
+        case PCAPNG_IDB:
+            if (bodyLen < 8) return fail("pcapng ӿ", size);
+            addInterface(body, bodyLen);
+            break;
+        case PCAPNG_EPB:
+        case PCAPNG_PB: {
+            if (bodyLen < 20) return fail("pcapng ݰ", size);
+            const uint32_t ifId = (type == PCAPNG_EPB) ? rd32(body) : rd16(body);
+            const uint32_t capLen = rd32(body + 12);
+            if (capLen > bodyLen - 20) return fail("pcapng ݰȳ鷶Χ", size);
+            if (ifId >= interfaces.size()) return fail("pcapng ݰδĽӿ", size);
+            const uint64_t ts = ((uint64_t)rd32(body + 4) << 32) | rd32(body + 8);
+            addPacket(from + 28, capLen, interfaces[ifId], ts, spans);
+            break;
+        }
+        case PCAPNG_SPB: {
+            if (bodyLen < 4) return fail("pcapng ݰ", size);
+            if (interfaces.empty()) return fail("pcapng ݰδĽӿ", size);
+            // ݰֻ¼ԭʼȣץȡܿСӿ snaplen ƣûʱ
+            size_t capLen = rd32(body);
+            if (capLen > bodyLen - 4) capLen = bodyLen - 4;
+            if (interfaces[0].snapLen != 0 && capLen > interfaces[0].snapLen) capLen = interfaces[0].snapLen;
+            addPacket(from + 12, (uint32_t)capLen, interfaces[0], 0, spans);
+            break;
+        }
+        default:
+            break; // ƽͳƵ֡޹
+        }
+        from += len;
+    }
+    if (atEnd && from < size) {
+        return fail("ļĩβ pcapng 鲻", size);
+    }
+    return from;
+}
+
+void CaptureReader::addInterface(const unsigned char* body, size_t len) {
+    Interface ifc;
+    ifc.ethernet = rd16(body) == LINKTYPE_ETHERNET;
+    ifc.snapLen = rd32(body + 4);
+    ifc.tsUnits = 1000000; // ĬϾΪ΢
+
+    size_t n = 0;
+    const unsigned char* v = findOption(body + 8, len - 8, bigEndian, PCAPNG_OPT_TSRESOL, n);
+    if (v && n >= 1) {
+        // λΪ0ʱΪ 10^-x 룬Ϊ1ʱΪ 2^-x 
+        const unsigned int x = v[0] & 0x7F;
+        if (v[0] & 0x80) {
+            if (x < 64) ifc.tsUnits = (uint64_t)1 << x;
+        }
+        else if (x <= 19) {
+            ifc.tsUnits = 1;
+            for (unsigned int i = 0; i < x; ++i) ifc.tsUnits *= 10;
+        }
+    }
+    interfaces.push_back(ifc);
+}
+
+void CaptureReader::addPacket(size_t start, uint32_t capLen, const Interface& ifc, uint64_t ts, vector<FrameSpan>& spans) {
+    if (!ifc.ethernet) {
+        return;
+    }
+    FrameSpan span{ start, start + capLen };
+    span.tsSec = (uint32_t)(ts / ifc.tsUnits);
+    const uint64_t frac = ts % ifc.tsUnits;
+    span.tsUsec = (ifc.tsUnits == 1000000) ? (uint32_t)frac : (uint32_t)((double)frac * 1e6 / (double)ifc.tsUnits);
+    spans.push_back(span);
+}
+
+// ------------------ pcap  ------------------
+
+CaptureWriter::~CaptureWriter() {
+    if (fp) fclose(fp);
+}
+
+bool CaptureWriter::open(const char* path) {
+    fp = fopen(path, "wb");
+    if (!fp) {
+        return false;
+    }
+    TextBuffer header(PCAP_HEADER_LEN);
+    header.le(PCAP_MAGIC_US, 4).le(2, 2).le(4, 2); // 汾 2.4
+    header.le(0, 4).le(0, 4);                       // ʱʱ
+    header.le(WRITE_SNAPLEN, 4).le(LINKTYPE_ETHERNET, 4);
+    write(header);
+    return true;
+}
+
+void CaptureWriter::appendRecord(TextBuffer& out, const FrameInfo& f) {
+    const size_t len = ETH_HEADER_LEN + f.payloadLen;
+    out.le(f.tsSec, 4).le(f.tsUsec, 4).le(len, 4).le(len, 4);
+    out.put((const char*)f.header, len);
+}
+
+void CaptureWriter::write(TextBuffer& records) {
+    if (fp && !records.empty()) {
+        fwrite(records.data(), 1, records.size(), fp);
+    }
+    records.clear();
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "FrameScanner.h"
+#include "FrameDecoder.h"
+#include "../Common/TextBuffer.h"
+
+// ------------------ ץļ (pcap / pcapng) ------------------
+
+/**
+ * @brief ݵĸʽ
+ */
+enum class CaptureFormat {
+    Raw,    // ԭʼ֡ʽǰ + ֡ + FCS
+    Pcap,   // libpcap ʽ
+    Pcapng  // pcapng ʽ
+};
+
+/**
+ * @brief ץļͷйصϢ
+ */
+struct CaptureInfo {
+    CaptureFormat format = CaptureFormat::Raw;
+    int fcsLen = 0; // ļÿ֡ FCS ֽpcap ·е FCS λpcapng һӿڵ if_fcslen
+};
+
+// ʶʽȡ pcap ļͷֽ
+const size_t CAPTURE_PROBE_BYTES = 24;
+
+/**
+ * @brief ļͷħжʽȡļͷ FCS 
+ *
+ * pcapng ֻͷĽӿ飬Ҹÿ data ΧڣΪ FCS
+ * @param data 뿪ͷ
+ * @param size ݳ
+ */
+CaptureInfo probeCapture(const unsigned char* data, size_t size);
+
+/**
+ * @brief ץļļ¼ȡ
+ *
+ * ֱ봰аͷתÿ̫¼һָ֡ݵ FrameSpan
+ * ݡΪÿ֡ڴ档̫ӿڵļ¼͵Ŀ鱻
+ * ʽ¼error() ԭ
+ */
+class CaptureReader {
+public:
+    explicit CaptureReader(CaptureFormat fmt);
+
+    /**
+     * @brief  data[from, size) ļ¼뷵ֵͬ splitFrames
+     */
+    size_t split(const unsigned char* data, size_t size, size_t from, bool atEnd, std::vector<FrameSpan>& spans);
+
+    CaptureFormat format() const {
+        return fileFormat;
+    }
+
+    /**
+     * @brief ʽûдʱΪ
+     */
+    const std::string& error() const {
+        return err;
+    }
+
+private:
+    /**
+     * @brief pcapng ӿõ
+     */
+    struct Interface {
+        bool ethernet;     // ·ǷΪ̫
+        uint64_t tsUnits;  // ÿʱλ (if_tsresol)
+        uint32_t snapLen;  // ץȡ
+    };
+
+    uint16_t rd16(const unsigned char* p) const;
+    uint32_t rd32(const unsigned char* p) const;
+    size_t fail(const char* msg, size_t size);
+    size_t splitPcap(const unsigned char* data, size_t size, size_t from, bool atEnd, std::vector<FrameSpan>& spans);
+    size_t splitPcapng(const unsigned char* data, size_t size, size_t from, bool atEnd, std::vector<FrameSpan>& spans);
+    void addInterface(const unsigned char* body, size_t len);
+    void addPacket(size_t start, uint32_t capLen, const Interface& ifc, uint64_t ts, std::vector<FrameSpan>& spans);
+
+    CaptureFormat fileFormat;
+    bool headerDone = false;     // pcap ļͷǷѶ
+    bool bigEndian = false;      // ļpcapng Ϊǰڣֽ
+    bool nanosecond = false;     // pcap ʱǷΪ뾫
+    std::vector<Interface> interfaces; // pcapng ǰڵĽӿ
+    std::string err;
+};
+
+/**
+ * @brief  pcap ʽļ΢ʱ·Ϊ̫ FCS
+ */
+class CaptureWriter {
+public:
+    CaptureWriter() = default;
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+    ~CaptureWriter();
+
+    /**
+     * @brief ļдļͷ
+     * @return ޷ʱ false
+     */
+    bool open(const char* path);
+
+    /**
+     * @brief һ֡֡ͷ + ֶΣʽΪһ pcap ¼׷ӵ
+     */
+    static void appendRecord(TextBuffer& out, const FrameInfo& f);
+
+    /**
+     * @brief деļ¼ջ
+     */
+    void write(TextBuffer& records);
+
+private:
+    FILE* fp = nullptr;
+};
@@ -0,0 +1,285 @@
+#include "Checksum.h"
+#include "CpuFeatures.h"
+
+#ifdef ANALYZER_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// ------------------ ұ ------------------
+
+struct Crc8Tables {
+    // t[k][b]ֽ b ֮پ k ֽڵ CRC 
+    uint8_t t[8][256];
+
+    Crc8Tables() {
+        const uint8_t poly = 0x07;
+        for (int i = 0; i < 256; ++i) {
+            uint8_t crc = (uint8_t)i;
+            for (int b = 0; b < 8; ++b) {
+                crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ poly) : (uint8_t)(crc << 1);
+            }
+            t[0][i] = crc;
+        }
+        for (int k = 1; k < 8; ++k) {
+            for (int i = 0; i < 256; ++i) {
+                t[k][i] = t[0][t[k - 1][i]];
+            }
+        }
+    }
+};
+
+struct Crc32Tables {
+    // ʽt[k][b] Ϊֽ b ֮پ k ֽڵ
+    uint32_t t[8][256];
+
+    Crc32Tables() {
+        const uint32_t poly = 0xEDB88320u;
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int b = 0; b < 8; ++b) {
+                crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+            }
+            t[0][i] = crc;
+        }
+        for (int k = 1; k < 8; ++k) {
+            for (int i = 0; i < 256; ++i) {
+                t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+const Crc8Tables crc8Tables;
+const Crc32Tables crc32Tables;
+
+inline uint32_t load32le(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Ƭ CRC-32 Ϊȡڲ״̬
+ */
+uint32_t crc32Slice8(uint32_t crc, const unsigned char* p, size_t len) {
+    const uint32_t (*t)[256] = crc32Tables.t;
+    while (len >= 8) {
+        uint32_t one = load32le(p) ^ crc;
+        uint32_t two = load32le(p + 4);
+        crc = t[7][one & 0xFF] ^ t[6][(one >> 8) & 0xFF] ^ t[5][(one >> 16) & 0xFF] ^ t[4][one >> 24]
+            ^ t[3][two & 0xFF] ^ t[2][(two >> 8) & 0xFF] ^ t[1][(two >> 16) & 0xFF] ^ t[0][two >> 24];
+        p += 8;
+        len -= 8;
+    }
+    while (len--) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef ANALYZER_X86
+
+/**
+ * @brief ޽λ˷۵Intel Ƥ "Fast CRC Computation Using PCLMULQDQ"
+ * @param crc ȡڲ״̬
+ * @param p ָ
+ * @param len ݳȣ64ֽΪ16ı
+ */
+#if defined(__GNUC__)
+__attribute__((target("sse4.1,pclmul")))
+#endif
+uint32_t crc32Clmul(uint32_t crc, const unsigned char* p, size_t len) {
+    // µ۵ Barrett Լ
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+    const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124LL);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    __m128i x1 = _mm_loadu_si128((const __m128i*)(p + 0x00));
+    __m128i x2 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+    __m128i x3 = _mm_loadu_si128((const __m128i*)(p + 0x20));
+    __m128i x4 = _mm_loadu_si128((const __m128i*)(p + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    p += 64;
+    len -= 64;
+
+    // 4·Уÿ۵64ֽ
+    while (len >= 64) {
+        __m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i*)(p + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i*)(p + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i*)(p + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i*)(p + 0x30)));
+        p += 64;
+        len -= 64;
+    }
+
+    // 4128λĴϲΪ1
+    __m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // ʣ16ֽڿ۵
+    while (len >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i*)p)), x5);
+        p += 16;
+        len -= 16;
+    }
+
+    // 128λ۵Ϊ64λ
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett ԼΪ32λ
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+
+/**
+ * @brief  x^n mod PP Ϊ CRC-8 ʽ x^8 + x^2 + x + 1
+ */
+uint64_t crc8XPow(unsigned int n) {
+    unsigned int r = 1; // 9λڵʽ
+    while (n--) {
+        r <<= 1;
+        if (r & 0x100) r ^= 0x107;
+    }
+    return r;
+}
+
+/**
+ * @brief CRC-8 ޽λ˷۵ݰʽȡģ۵Ϊ128λʽ16ֽٲ
+ *
+ * CRC-8 ǷʽݰװĴÿ64λ벿Բ8λĳ
+ * ˻72λ۵в128λ
+ * @param p ָ
+ * @param len ݳȣ64ֽΪ16ı
+ * @param out ͬ128λʽ˴
+ */
+#if defined(__GNUC__)
+__attribute__((target("sse4.1,pclmul")))
+#endif
+void crc8Clmul(const unsigned char* p, size_t len, unsigned char out[16]) {
+    static const uint64_t k512 = crc8XPow(512), k576 = crc8XPow(576);
+    static const uint64_t k128 = crc8XPow(128), k192 = crc8XPow(192);
+    const __m128i fold4 = _mm_set_epi64x((long long)k576, (long long)k512);
+    const __m128i fold1 = _mm_set_epi64x((long long)k192, (long long)k128);
+    const __m128i bswap = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+
+    __m128i x1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(p + 0x00)), bswap);
+    __m128i x2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(p + 0x10)), bswap);
+    __m128i x3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(p + 0x20)), bswap);
+    __m128i x4 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(p + 0x30)), bswap);
+    p += 64;
+    len -= 64;
+
+    // 4·Уÿ۵64ֽڣx = hi * (x^576 mod P) + lo * (x^512 mod P) + 
+    while (len >= 64) {
+        x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, fold4, 0x00), _mm_clmulepi64_si128(x1, fold4, 0x11)),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(p + 0x00)), bswap));
+        x2 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x2, fold4, 0x00), _mm_clmulepi64_si128(x2, fold4, 0x11)),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(p + 0x10)), bswap));
+        x3 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x3, fold4, 0x00), _mm_clmulepi64_si128(x3, fold4, 0x11)),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(p + 0x20)), bswap));
+        x4 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x4, fold4, 0x00), _mm_clmulepi64_si128(x4, fold4, 0x11)),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(p + 0x30)), bswap));
+        p += 64;
+        len -= 64;
+    }
+
+    // 4Ĵκϲ۵ʣ16ֽڿ
+    x2 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, fold1, 0x00), _mm_clmulepi64_si128(x1, fold1, 0x11)), x2);
+    x3 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x2, fold1, 0x00), _mm_clmulepi64_si128(x2, fold1, 0x11)), x3);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x3, fold1, 0x00), _mm_clmulepi64_si128(x3, fold1, 0x11)), x4);
+    while (len >= 16) {
+        x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, fold1, 0x00), _mm_clmulepi64_si128(x1, fold1, 0x11)),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)p), bswap));
+        p += 16;
+        len -= 16;
+    }
+    _mm_storeu_si128((__m128i*)out, _mm_shuffle_epi8(x1, bswap));
+}
+
+#endif // ANALYZER_X86
+
+bool useClmul() {
+#ifdef ANALYZER_X86
+    static const bool ok = cpuFeatures().pclmul && cpuFeatures().sse41;
+    return ok;
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+uint8_t calcCRC8(const unsigned char* data, size_t len) {
+    const uint8_t (*t)[256] = crc8Tables.t;
+    uint8_t crc = 0x00;
+#ifdef ANALYZER_X86
+    if (len >= 64 && useClmul()) {
+        // ǰ16ֽڿ۵Ϊ16ֽʽCRCԭͬ²ֽŲ
+        size_t chunk = len & ~(size_t)15;
+        unsigned char folded[16];
+        crc8Clmul(data, chunk, folded);
+        for (int i = 0; i < 16; ++i) {
+            crc = t[0][crc ^ folded[i]];
+        }
+        data += chunk;
+        len -= chunk;
+    }
+#endif
+    // һδ8ֽڣֻ8λֻһֽںϲ
+    while (len >= 8) {
+        crc = t[7][crc ^ data[0]] ^ t[6][data[1]] ^ t[5][data[2]] ^ t[4][data[3]]
+            ^ t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+        data += 8;
+        len -= 8;
+    }
+    while (len--) {
+        crc = t[0][crc ^ *data++];
+    }
+    return crc;
+}
+
+uint32_t calcCRC32(const unsigned char* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFFu;
+#ifdef ANALYZER_X86
+    if (len >= 64 && useClmul()) {
+        size_t chunk = len & ~(size_t)15;
+        crc = crc32Clmul(crc, data, chunk);
+        data += chunk;
+        len -= chunk;
+    }
+#endif
+    crc = crc32Slice8(crc, data, len);
+    return ~crc;
+}
+
+const char* crcKernelName() {
+    return useClmul() ? "PCLMULQDQ" : "slicing-by-8";
+}
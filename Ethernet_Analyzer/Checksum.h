@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// ------------------ Уͼ ------------------
+
+/**
+ * @brief ֡β FCS ʹõУ㷨
+ */
+enum class FcsType {
+    Crc8,  // 1ֽ CRC-8 (ʽ 0x07)ѧʾʹ
+    Crc32, // 4ֽ IEEE 802.3 CRC-32ʵ̫֡ʹ
+    None   // ֡в FCSץļˣֻȼ
+};
+
+/**
+ * @brief FCS ռֽ
+ */
+inline size_t fcsLength(FcsType type) {
+    switch (type) {
+    case FcsType::Crc32: return 4;
+    case FcsType::None:  return 0;
+    default:             return 1;
+    }
+}
+
+/**
+ * @brief CRC8У루ʽ 0x07ֵ 0
+ *
+ * CPU ֧ PCLMULQDQ ʱʹ޽λ˷۵8ֽڷƬ
+ * @param data ָ
+ * @param len ݳ
+ * @return 8λCRCУ
+ */
+uint8_t calcCRC8(const unsigned char* data, size_t len);
+
+/**
+ * @brief ̫ FCS ʹõ CRC-32IEEE 802.3ʽ 0xEDB88320
+ *
+ * CPU ֧ PCLMULQDQ ʱʹ޽λ˷۵8ֽڷƬ
+ * @param data ָ
+ * @param len ݳ
+ * @return 32λCRCУ룻֡е FCS С˳Ÿֵ
+ */
+uint32_t calcCRC32(const unsigned char* data, size_t len);
+
+/**
+ * @brief ָ㷨У
+ */
+inline uint32_t calcFcs(FcsType type, const unsigned char* data, size_t len) {
+    switch (type) {
+    case FcsType::Crc32: return calcCRC32(data, len);
+    case FcsType::None:  return 0;
+    default:             return calcCRC8(data, len);
+    }
+}
+
+/**
+ * @brief ȡ֡дŵ FCSCRC-32 ΪС4ֽڣ
+ */
+inline uint32_t readFcs(FcsType type, const unsigned char* p) {
+    if (type == FcsType::None) {
+        return 0;
+    }
+    if (type == FcsType::Crc8) {
+        return p[0];
+    }
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief ǰ CRC ʹõʵ ("PCLMULQDQ"  "slicing-by-8")
+ */
+const char* crcKernelName();
@@ -0,0 +1,75 @@
+#include "CpuFeatures.h"
+
+#ifdef ANALYZER_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace {
+
+#ifdef ANALYZER_X86
+/**
+ * @brief ִ CPUID ָ
+ * @param leaf ܺ (EAX)
+ * @param sub ӹܺ (ECX)
+ * @param regs  EAX, EBX, ECX, EDX
+ */
+void cpuid(unsigned int leaf, unsigned int sub, unsigned int regs[4]) {
+#ifdef _MSC_VER
+    int r[4];
+    __cpuidex(r, (int)leaf, (int)sub);
+    for (int i = 0; i < 4; ++i) regs[i] = (unsigned int)r[i];
+#else
+    __cpuid_count(leaf, sub, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+/**
+ * @brief ȡ XCR0жϲϵͳǷ񱣴 YMM Ĵ״̬
+ */
+unsigned long long readXcr0() {
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    unsigned int lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((unsigned long long)hi << 32) | lo;
+#endif
+}
+
+CpuFeatures detect() {
+    CpuFeatures f;
+    unsigned int r[4];
+    cpuid(0, 0, r);
+    unsigned int maxLeaf = r[0];
+    if (maxLeaf < 1) return f;
+
+    cpuid(1, 0, r);
+    f.sse2 = (r[3] >> 26) & 1;
+    f.sse41 = (r[2] >> 19) & 1;
+    f.pclmul = (r[2] >> 1) & 1;
+    bool osxsave = (r[2] >> 27) & 1;
+    bool avx = (r[2] >> 28) & 1;
+
+    // AVX2 Ҫϵͳ XMM/YMM ״̬
+    if (maxLeaf >= 7 && osxsave && avx && (readXcr0() & 0x6) == 0x6) {
+        cpuid(7, 0, r);
+        f.avx2 = (r[1] >> 5) & 1;
+    }
+    return f;
+}
+#else
+CpuFeatures detect() {
+    return CpuFeatures();
+}
+#endif
+
+} // namespace
+
+const CpuFeatures& cpuFeatures() {
+    static const CpuFeatures features = detect();
+    return features;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+// ------------------ CPU ָ ------------------
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define ANALYZER_X86 1
+#endif
+
+/**
+ * @brief ʱ⵽ CPU ָ֧
+ */
+struct CpuFeatures {
+    bool sse2 = false;
+    bool sse41 = false;
+    bool avx2 = false;
+    bool pclmul = false;
+};
+
+/**
+ * @brief ȡǰ CPU ֵָ֧״εʱͨ CPUID ⣬֮󷵻ػ
+ */
+const CpuFeatures& cpuFeatures();
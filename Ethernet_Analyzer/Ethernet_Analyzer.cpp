@@ -1,250 +1,602 @@
 #include <iostream>
-#include <fstream>
-#include <iomanip>
-#include <sstream>
-#include <vector>
 #include <string>
+#include <vector>
 #include <cstdint>
-#include <cstring>
-#include <array>
+#include <cstdlib>
 #include <cctype>
-#include <iterator>
+#include <cstring>
+#include <csignal>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <chrono>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include "InputSource.h"
+#include "FrameScanner.h"
+#include "Checksum.h"
+#include "FrameDecoder.h"
+#include "FrameReport.h"
+#include "CaptureFile.h"
+#include "FrameIndex.h"
+#include "FrameBench.h"
+#include "FrameFilter.h"
+#include "ParallelDecoder.h"
 
 using namespace std;
 
-// ------------------ ߺ ------------------
+// ------------------ в ------------------
+
+/**
+ * @brief ѡ
+ */
+struct Options {
+    const char* path = nullptr;  // ֡ļ·"-" ʾ׼
+    FcsType fcs = FcsType::Crc8; // ֡βУ㷨
+    bool fcsSet = false;         // ǷʽָУ㷨δָʱץļļͷѡ
+    unsigned int jobs = 1;       // ߳1 Ϊ߳
+    OutputFormat format = OutputFormat::Text; // ʽ
+    const char* saveAccepted = nullptr; // ֡Ϊ pcap ļ
+    const char* saveRejected = nullptr; // ܾ֡Ϊ pcap ļ
+    bool stats = false;          // ֻͳϢ
+    bool follow = false;         // ٳļ
+    bool buildIndex = false;     // ֡
+    uint64_t queryFirst = 0;     // ѯĵһ֡1ʼ0 ʾѯ
+    uint64_t queryLast = 0;      // ѯһ֡
+    unsigned int benchRounds = 0; // ܲÿ׶ε0 ʾ
+    bool filtered = false;       // Ƿָ˹˱ʽ
+    FrameFilter filter;          // Ĺ˱ʽ
+};
+
+/**
+ * @brief ӡ÷˵
+ * @param prog 
+ */
+void printUsage(const char* prog) {
+    cout << "÷: " << prog << " [ѡ] [֡ļ·]" << endl;
+    cout << "ʾ: Ethernet_Analyzer.exe input" << endl;
+    cout << "      ļ·Ϊ - ʱӱ׼ȡpcap / pcapng ץļļͷԶʶ" << endl;
+    cout << "ѡ:" << endl;
+    cout << "  --fcs=crc8|crc32|none" << endl;
+    cout << "                     ֡βУ㷨crc8 Ϊ1ֽ CRC-8ԭʼ֡ļĬϣcrc32 Ϊ4ֽ̫ FCS" << endl;
+    cout << "                     none ʾ֡в FCSץļĬϰļͷ FCS ѡ" << endl;
+    cout << "  -j N               ʹ N ̲߳н0 ʾCPU뵥߳ͬ" << endl;
+    cout << "  --format=FMT       ʽtext Ϊ֡ı棨Ĭϣjsonl / csv Ϊÿ֡һУ" << endl;
+    cout << "                     bin ΪС˶Ƽ¼ʽ FrameReport.h" << endl;
+    cout << "  --stats            ֻ֡ͳ֡/ֶܾΡȷֲַ봦ٶ" << endl;
+    cout << "  --follow           ٳļݺȴֻ׷ӵ֡Ctrl+C " << endl;
+    cout << "                     ̣߳ԭʼ֡ļһ֡һ֡ǰ뵽ʱ" << endl;
+    cout << "  --build-index      Ϊ֡ļļ· + .idx֡" << endl;
+    cout << "  --frame N          ֻ N ֡ڻԴļѸıʱԶؽ" << endl;
+    cout << "  --range A:B        ֻ A  B ֡" << endl;
+    cout << "  --bench[=N]        ֽ׶βԭʼ֡ļĴٶȣǰɨ衢У顢 --format ʽ" << endl;
+    cout << "                     ÿ׶ظ N ֣Ĭ 5ȡһ" << endl;
+    cout << "  --filter=EXPR      ֻʽ֡֡Ų䣻 \"ip_src==10.0.0.1 && tcp && port==80\"" << endl;
+    cout << "                     \"status==Reject || len<46\"\"!(ethertype==arp)\"ֶ﷨ FrameFilter.h" << endl;
+    cout << "  --save-accepted=F  ѽյ֡Ϊ pcap ļ F" << endl;
+    cout << "  --save-rejected=F  Ѿܾ֡Ϊ pcap ļ F" << endl;
+}
+
+/**
+ * @brief  --frame / --range Ĳ
+ * @param value "N"  "A:B"
+ * @param isRange ǷΪ --range
+ * @param opt ѯΧ
+ * @return ʽΧΪշ false
+ */
+bool parseFrameRange(const string& value, bool isRange, Options& opt) {
+    char* end = nullptr;
+    const unsigned long long first = strtoull(value.c_str(), &end, 10);
+    unsigned long long last = first;
+    if (isRange) {
+        if (*end != ':') return false;
+        const char* second = end + 1;
+        last = strtoull(second, &end, 10);
+        if (end == second) return false;
+    }
+    if (value.empty() || !isdigit((unsigned char)value[0]) || *end != '\0' || first == 0 || last < first) {
+        return false;
+    }
+    opt.queryFirst = first;
+    opt.queryLast = last;
+    return true;
+}
 
 /**
- * @brief CRC8У
- * @param data ָ
- * @param len ݳ
- * @return 8λCRCУ
+ * @brief в
+ * @param argc 
+ * @param argv 
+ * @param opt 
+ * @return Ϸ trueϢ false
  */
-uint8_t calcCRC8(const unsigned char* data, size_t len) {
-    uint8_t crc = 0x00;
-    const uint8_t poly = 0x07;
-    for (size_t i = 0; i < len; ++i) {
-        crc ^= data[i];
-        for (int b = 0; b < 8; ++b) {
-            if (crc & 0x80) {
-                crc = (uint8_t)((crc << 1) ^ poly);
+bool parseArgs(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--fcs=crc8") {
+            opt.fcs = FcsType::Crc8;
+            opt.fcsSet = true;
+        }
+        else if (arg == "--fcs=crc32") {
+            opt.fcs = FcsType::Crc32;
+            opt.fcsSet = true;
+        }
+        else if (arg == "--fcs=none") {
+            opt.fcs = FcsType::None;
+            opt.fcsSet = true;
+        }
+        else if (arg == "--stats") {
+            opt.stats = true;
+        }
+        else if (arg == "--bench" || arg.compare(0, 8, "--bench=") == 0) {
+            const long n = (arg.size() > 8) ? strtol(arg.c_str() + 8, nullptr, 10) : 5;
+            if (n <= 0) {
+                cerr << "Ч: " << arg << endl;
+                return false;
             }
-            else {
-                crc = (uint8_t)(crc << 1);
+            opt.benchRounds = (unsigned int)n;
+        }
+        else if (arg == "--follow") {
+            opt.follow = true;
+        }
+        else if (arg == "--build-index") {
+            opt.buildIndex = true;
+        }
+        else if (arg == "--frame" || arg == "--range") {
+            const string value = (i + 1 < argc) ? argv[++i] : "";
+            if (!parseFrameRange(value, arg == "--range", opt)) {
+                cerr << "֡Ч: " << value << endl;
+                return false;
+            }
+        }
+        else if (arg == "--filter" || arg.compare(0, 9, "--filter=") == 0) {
+            const string expr = (arg.size() > 8) ? arg.substr(9) : (i + 1 < argc ? argv[++i] : "");
+            if (!opt.filter.compile(expr)) {
+                cerr << "˱ʽ: " << opt.filter.error() << endl;
+                return false;
+            }
+            opt.filtered = true;
+        }
+        else if (arg.compare(0, 16, "--save-accepted=") == 0 && arg.size() > 16) {
+            opt.saveAccepted = argv[i] + 16;
+        }
+        else if (arg.compare(0, 16, "--save-rejected=") == 0 && arg.size() > 16) {
+            opt.saveRejected = argv[i] + 16;
+        }
+        else if (arg.compare(0, 9, "--format=") == 0) {
+            if (!parseOutputFormat(arg.c_str() + 9, opt.format)) {
+                cerr << "ʽЧ: " << arg.substr(9) << endl;
+                return false;
+            }
+        }
+        else if (arg == "-j" || (arg.size() > 2 && arg.compare(0, 2, "-j") == 0)) {
+            string value = arg.size() > 2 ? arg.substr(2) : (i + 1 < argc ? argv[++i] : "");
+            char* end = nullptr;
+            long n = strtol(value.c_str(), &end, 10);
+            if (value.empty() || *end != '\0' || n < 0 || n > 1024) {
+                cerr << "߳Ч: " << value << endl;
+                return false;
             }
+            opt.jobs = (n == 0) ? thread::hardware_concurrency() : (unsigned int)n;
+            if (opt.jobs == 0) opt.jobs = 1;
         }
+        else if (arg.size() > 1 && arg[0] == '-') {
+            cerr << "δ֪ѡ: " << arg << endl;
+            return false;
+        }
+        else if (opt.path == nullptr) {
+            opt.path = argv[i];
+        }
+        else {
+            cerr << "ָֻһ֡ļ" << endl;
+            return false;
+        }
+    }
+    if (opt.path == nullptr) {
+        cerr << "δָ֡ļ" << endl;
+        return false;
     }
-    return crc;
+    if (opt.follow && (opt.buildIndex || opt.queryFirst != 0)) {
+        cerr << "--follow  --build-index--frame--range ͬʱʹ" << endl;
+        return false;
+    }
+    if (opt.filtered && opt.buildIndex) {
+        cerr << "--filter  --build-index ͬʱʹãҪȫ֡" << endl;
+        return false;
+    }
+    return true;
 }
 
+// ------------------ ߳̽ ------------------
+
 /**
- * @brief ֽתΪλʮַ
- * @param b ֽ
- * @return ʮƱʾַ
+ * @brief νеȫ֡
+ * @param in Դ
+ * @param capture ץļļ¼ȡԭʼ֡ļΪ nullptr
+ * @param fcsType ֡βУ㷨
+ * @param reporter 
+ * @return Ч֡
  */
-string byteToHex(unsigned char b) {
-    stringstream ss;
-    ss << uppercase << hex << setw(2) << setfill('0') << (int)b;
-    return ss.str();
+int analyzeSerial(InputSource& in, CaptureReader* capture, FcsType fcsType, FrameReporter& reporter) {
+    uint64_t filePos = 0; // ǰλеƫ
+    int frameCount = 0;
+    size_t scanBatch = SCAN_BATCH;
+    vector<FrameSpan> spans;
+    FrameInfo f;
+    ReportBuffers out;
+
+    for (;;) {
+        // ¾Ϊڵ±ꣻеݲȷǰ֡ʱݺ filePos 
+        const ByteWindow win = in.window();
+        const size_t pos = (size_t)(filePos - win.base);
+
+        // 1. ɨһݣǰ (7 x 0xAA + 0xAB) ֳ߽ȷ֡ץļ¼ͷ
+        const size_t scanEnd = (win.size - pos > scanBatch) ? pos + scanBatch : win.size;
+        const bool atEnd = win.eof && scanEnd == win.size;
+        spans.clear();
+        const size_t resume = capture
+            ? capture->split(win.data, scanEnd, pos, atEnd, spans)
+            : splitFrames(win.data, scanEnd, pos, atEnd, spans);
+
+        for (const FrameSpan& span : spans) {
+            // 2. һǰ루ļĩβǰ֡ı߽磬֡ͷFCS
+            const bool ok = capture
+                ? decodePacket(win.data, span, fcsType, f, reporter.fcsOnDecode())
+                : decodeFrame(win.data, span, fcsType, f, reporter.fcsOnDecode());
+            if (!ok) {
+                continue;
+            }
+            // 3. ܹһһд
+            reporter.frame(out, f, ++frameCount, win.base + span.start);
+            if (out.full()) reporter.write(out);
+        }
+
+        filePos = win.base + resume;
+        if (atEnd) {
+            break;
+        }
+        in.release(filePos);
+        if (scanEnd < win.size) {
+            // лδɨݣδǰ˵֡Ӵɨ
+            scanBatch = (resume > pos) ? SCAN_BATCH : scanBatch * 2;
+            continue;
+        }
+        // ݿܵģʽдѽĽ
+        reporter.write(out);
+        in.refill(filePos);
+    }
+    reporter.write(out);
+    reporter.collect(out);
+    return frameCount;
 }
 
+// ------------------ ѯ ------------------
+
 /**
- * @brief 6ֽڵMACַʽΪ "XX-XX-XX-XX-XX-XX"
- * @param data MACַֽ
- * @param start MACַеʼ
- * @return ʽMACַַ
+ * @brief ļͷʶ pcap / pcapngδָУ㷨ʱʹļͷ FCS 
+ * @param in Դδʼ
+ * @param opt ѡܸеУ㷨
+ * @return ץļؼ¼ȡԭʼ֡ļ nullptr
  */
-string macToStr(const vector<unsigned char>& data, int start) {
-    stringstream ss;
-    for (int i = 0; i < 6; i++) {
-        ss << byteToHex(data[start + i]);
-        if (i != 5) {
-            ss << "-";
-        }
+unique_ptr<CaptureReader> probeInput(InputSource& in, Options& opt) {
+    const ByteWindow head = in.window();
+    const CaptureInfo info = probeCapture(head.data, head.size);
+    if (info.format == CaptureFormat::Raw) {
+        return nullptr;
     }
-    return ss.str();
+    if (!opt.fcsSet) {
+        opt.fcs = (info.fcsLen == 4) ? FcsType::Crc32 : FcsType::None;
+    }
+    return unique_ptr<CaptureReader>(new CaptureReader(info.format));
 }
 
 /**
- * @brief 6ֽڵMACַʽΪ "XX-XX-XX-XX-XX-XX"
- * @param data ָMACַݵָ
- * @return ʽMACַַ
+ * @brief ͷֺ
+ * @return Ч֡
  */
-string macToStr(const unsigned char* data) {
-    stringstream ss;
-    for (int i = 0; i < 6; i++) {
-        ss << uppercase << hex << setw(2) << setfill('0') << (int)data[i];
-        if (i != 5) {
-            ss << "-";
-        }
+int runAnalysis(InputSource& in, CaptureReader* capture, const Options& opt, FrameReporter& reporter) {
+    {
+        ReportBuffers header;
+        reporter.begin(header);
+        reporter.write(header);
     }
-    ss << dec; // ָΪʮ
-    return ss.str();
+    return (opt.jobs > 1)
+        ? analyzeParallel(in, capture, opt.fcs, opt.jobs, reporter)
+        : analyzeSerial(in, capture, opt.fcs, reporter);
 }
 
 /**
- * @brief ֽݸʽΪASCIIַɴӡַʾΪ'.'
- * @param data ָ
- * @param len ݳ
- * @return ASCIIʾַ
+ * @brief 벢дļ
+ * @param in Դδʼ
+ * @param capture ץļļ¼ȡԭʼ֡ļΪ nullptr
+ * @param opt ѡ
+ * @param src Դļ
+ * @param indexPath ļ·
+ * @return ɹд֡ʧܷ -1
  */
-string formatDataAscii(const unsigned char* data, size_t len) {
-    stringstream ss;
-    for (size_t i = 0; i < len; ++i) {
-        unsigned char c = data[i];
-        ss << (isprint(c) ? (char)c : '.');
+long long buildIndexFile(InputSource& in, CaptureReader* capture, const Options& opt, const IndexSource& src, const string& indexPath) {
+    FrameIndexWriter writer;
+    if (!writer.open(indexPath, src)) {
+        cerr << "޷ļ: " << indexPath << endl;
+        return -1;
     }
-    return ss.str();
+    ReportOptions ro;
+    ro.fcs = opt.fcs;
+    ro.frames = false;
+    ro.index = &writer;
+    FrameReporter reporter(ro);
+    runAnalysis(in, capture, opt, reporter);
+    if (capture && !capture->error().empty()) {
+        cerr << "ץļʽ: " << capture->error() << endl;
+        return -1;
+    }
+    if (!writer.finish()) {
+        cerr << "дļʧ: " << indexPath << endl;
+        return -1;
+    }
+    return (long long)writer.count();
 }
 
-// ------------------  ------------------
-int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        cout << "÷: " << argv[0] << " [֡ļ·]" << endl;
-        cout << "ʾ: Ethernet_Analyzer.exe input" << endl;
-        return 0;
+/**
+ * @brief Դļǰ½
+ * @param src Դļ
+ * @return ʧʱԭ򣬷 false
+ */
+bool rebuildIndex(Options& opt, const string& indexPath, IndexSource& src, FrameIndex& index) {
+    if (!statSource(opt.path, src)) {
+        cerr << "֡ѯҪͨļ: " << opt.path << endl;
+        return false;
+    }
+    unique_ptr<InputSource> in = openInput(opt.path);
+    if (!in) {
+        cerr << "޷ļ: " << opt.path << endl;
+        return false;
     }
+    unique_ptr<CaptureReader> capture = probeInput(*in, opt);
+    src.fcs = opt.fcs;
+    src.format = capture ? capture->format() : CaptureFormat::Raw;
+    if (buildIndexFile(*in, capture.get(), opt, src, indexPath) < 0) {
+        return false;
+    }
+    index = FrameIndex();
+    if (!index.open(indexPath)) {
+        cerr << "޷ȡļ: " << indexPath << endl;
+        return false;
+    }
+    return true;
+}
 
-    ifstream fin(argv[1], ios::binary);
-    if (!fin) {
-        cerr << "޷ļ: " << argv[1] << endl;
-        return 1;
+/**
+ * @brief ȡһ֡ȷԴļڸô¼֡
+ *
+ * ԭʼ֡ǰ뿪ͷǡһǰļĩβ
+ * ץļļ¼ûǰ룬ֻȡǷ
+ * @param fileSize ԴļС
+ * @return ȡһʱ false
+ */
+bool readIndexedFrame(FILE* fp, const IndexEntry& e, CaptureFormat format, uint64_t fileSize, vector<unsigned char>& bytes) {
+    if (format != CaptureFormat::Raw) {
+        return readAt(fp, e.offset, e.length, bytes);
+    }
+    const uint64_t end = e.offset + e.length;
+    if (e.length < PREAMBLE_LEN || end > fileSize) {
+        return false;
     }
+    // ͬһǰһ룻֡һǰӦһ֡
+    const size_t next = (size_t)min<uint64_t>(PREAMBLE_LEN, fileSize - end);
+    if (!readAt(fp, e.offset, e.length + next, bytes) || !isPreamble(bytes.data()) ||
+        (next != 0 && (next < PREAMBLE_LEN || !isPreamble(bytes.data() + e.length)))) {
+        return false;
+    }
+    bytes.resize(e.length);
+    return true;
+}
 
-    vector<unsigned char> data((istreambuf_iterator<char>(fin)), istreambuf_iterator<char>());
-    fin.close();
+/**
+ * @brief --frame / --rangeֱӶλָ֡
+ */
+int runQuery(Options& opt) {
+    IndexSource src;
+    if (strcmp(opt.path, "-") == 0 || !statSource(opt.path, src)) {
+        cerr << "֡ѯҪͨļ: " << opt.path << endl;
+        return 1;
+    }
+    unique_ptr<InputSource> in = openInput(opt.path);
+    if (!in) {
+        cerr << "޷ļ: " << opt.path << endl;
+        return 1;
+    }
+    unique_ptr<CaptureReader> capture = probeInput(*in, opt);
+    src.fcs = opt.fcs;
+    src.format = capture ? capture->format() : CaptureFormat::Raw;
 
-    size_t pos = 0;
-    int frameCount = 0;
-    const array<unsigned char, 8> preamble = { {0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAB} };
-    const size_t total = data.size();
-
-    while (pos + 8 <= total) {
-        // 1. ǰ (7 x 0xAA + 0xAB)
-        bool found = false;
-        while (pos + 8 <= total) {
-            if (memcmp(&data[pos], preamble.data(), preamble.size()) == 0) {
-                found = true;
-                break;
-            }
-            ++pos;
-        }
-        if (!found) {
-            break; // ļĩβδҵǰ
+    // ԴļĴС޸ʱУ㷨һʱؽ
+    const string indexPath = indexPathFor(opt.path);
+    FrameIndex index;
+    const bool current = index.open(indexPath) && index.matches(src);
+    in.reset();
+    capture.reset();
+    bool rebuilt = false;
+    if (!current) {
+        cerr << "ڻѹڣ½: " << indexPath << endl;
+        if (!rebuildIndex(opt, indexPath, src, index)) {
+            return 1;
         }
+        rebuilt = true;
+    }
 
-        size_t frameStart = pos; // ָһ0xAA
-        size_t payloadStart = frameStart + 8; // 7xAA + SFDָĿMACַ
+    if (opt.queryFirst > index.count()) {
+        cerr << "֡ųΧ:  " << index.count() << " ֡" << endl;
+        return 1;
+    }
+    uint64_t last = min(opt.queryLast, index.count());
 
-        // Ҫ 14ֽͷ + 1ֽFCS
-        if (payloadStart + 14 + 1 > total) {
+    FILE* fp = fopen(opt.path, "rb");
+    if (!fp) {
+        cerr << "޷ļ: " << opt.path << endl;
+        return 1;
+    }
+    ReportOptions ro;
+    ro.format = opt.format;
+    ro.fcs = opt.fcs;
+    ro.filter = opt.filtered ? &opt.filter : nullptr;
+    FrameReporter reporter(ro);
+    ReportBuffers out;
+    reporter.begin(out);
+
+    vector<unsigned char> bytes;
+    FrameInfo f;
+    int rc = 0;
+    for (uint64_t n = opt.queryFirst; n <= last; ++n) {
+        IndexEntry e;
+        if (!index.lookup(n, e)) {
+            cerr << "޷ȡ " << n << " ֡" << endl;
+            rc = 1;
             break;
         }
-
-        // 2. ͨһǰȷǰ֡ı߽
-        size_t nextPreamble = total;
-        for (size_t j = payloadStart + 1; j + 8 <= total; ++j) {
-            if (memcmp(&data[j], preamble.data(), preamble.size()) == 0) {
-                nextPreamble = j;
+        if (!readIndexedFrame(fp, e, index.format(), src.size, bytes)) {
+            // ޸ʱľޣԴļԿ󱻸дСʱ䲻
+            if (rebuilt) {
+                cerr << "޷ȡ " << n << " ֡" << endl;
+                rc = 1;
                 break;
             }
-        }
-
-        // 3. ȷCRC(FCS)λ
-        size_t crcOffset = 0; // FCSʼλ (1 byte)
-        if (nextPreamble == total) {
-            // ļеһ֡
-            if (total < 1) break;
-            crcOffset = total - 1;
-        }
-        else {
-            // һ֡Ƿ̫
-            if (nextPreamble < 1 || nextPreamble < payloadStart + 14 + 1) {
-                pos = nextPreamble; // ǰ֡Ϸһ֡
-                continue;
+            cerr << "Դļݲһ£½: " << indexPath << endl;
+            fclose(fp);
+            fp = fopen(opt.path, "rb");
+            if (!fp || !rebuildIndex(opt, indexPath, src, index)) {
+                if (!fp) cerr << "޷ļ: " << opt.path << endl;
+                rc = 1;
+                break;
             }
-            crcOffset = nextPreamble - 1;
+            rebuilt = true;
+            last = min(opt.queryLast, index.count());
+            --n; // ¶ȡһ֡
+            continue;
+        }
+        FrameSpan span{ 0, bytes.size() };
+        span.tsSec = e.tsSec;
+        span.tsUsec = e.tsUsec;
+        const bool ok = (index.format() == CaptureFormat::Raw)
+            ? decodeFrame(bytes.data(), span, opt.fcs, f, reporter.fcsOnDecode())
+            : decodePacket(bytes.data(), span, opt.fcs, f, reporter.fcsOnDecode());
+        if (ok) {
+            reporter.frame(out, f, (int)n, e.offset);
+            if (out.full()) reporter.write(out);
         }
+    }
+    reporter.write(out);
+    if (fp) fclose(fp);
+    return rc;
+}
 
-        size_t headerOffset = payloadStart;
-        size_t dataStart = headerOffset + 14;
+/**
+ * @brief Ctrl+C ٣Ѷݲͳƺ˳
+ */
+void onInterrupt(int) {
+    stopFollowing();
+}
 
-        if (crcOffset < dataStart) { // ȷݶγΪ0
-            pos = (nextPreamble == total) ? total : nextPreamble;
-            continue;
-        }
-        size_t dataLen = crcOffset - dataStart;
+// ------------------  ------------------
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 0;
+    }
 
-        // ֶγȽм
-        const size_t ETH_MIN_PAYLOAD = 46; //̫СЧغ
-        const size_t ETH_MAX_PAYLOAD = 1500; //̫Чغ(Jumbo֡)
-        bool length_ok = true;
-        if (dataLen < ETH_MIN_PAYLOAD) {
-            length_ok = false;
-        }
-        if (dataLen > ETH_MAX_PAYLOAD) {
-            length_ok = false;
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+#ifdef _WIN32
+    if (opt.format == OutputFormat::Bin) {
+        _setmode(_fileno(stdout), _O_BINARY); // Ƽ¼зת
+    }
+#endif
+    if (opt.benchRounds != 0) {
+        return runBenchmark(opt.path, opt.fcs, opt.format, opt.benchRounds);
+    }
+    if (opt.queryFirst != 0) {
+        return runQuery(opt);
+    }
+
+    // ͨļֱӳ䵽ڴ棬ܵ׼ʹûڣڴռļС޹أ
+    // ģʽͬʹûڣĩβʱȴļ
+    unique_ptr<InputSource> in = opt.follow ? openFollowInput(opt.path) : openInput(opt.path);
+    if (!in) {
+        cerr << "޷ļ: " << opt.path << endl;
+        return 1;
+    }
+    if (opt.follow) {
+        opt.jobs = 1;
+        signal(SIGINT, onInterrupt);
+        signal(SIGTERM, onInterrupt);
+        // մץļܻûдļͷʶʽ
+        while (!in->window().eof && in->window().size < CAPTURE_PROBE_BYTES) {
+            in->refill(0);
         }
+    }
+    unique_ptr<CaptureReader> capture = probeInput(*in, opt);
 
-        // 4. ȡļеFCSCRC
-        if (crcOffset + 1 > total) {
-            break;
+    if (opt.buildIndex) {
+        IndexSource src;
+        if (strcmp(opt.path, "-") == 0 || !statSource(opt.path, src)) {
+            cerr << "Ҫͨļ: " << opt.path << endl;
+            return 1;
         }
-        uint8_t fcs = data[crcOffset];
-
-        // CRC8㷶ΧĿMACֶַĩβFCS
-        size_t crcCalcLen = crcOffset - payloadStart;
-        uint8_t calc = calcCRC8(&data[payloadStart], crcCalcLen);
-
-        // 5. 
-        ++frameCount;
-        cout << ": " << setw(2) << setfill('0') << frameCount << endl;
-        cout << "------------------------------------------" << endl;
-        cout << "ǰ:     ";
-        for (int i = 0; i < 7; ++i) {
-            cout << byteToHex(data[frameStart + i]) << " ";
-        }
-        cout << endl;
-        cout << "֡ǰ: " << byteToHex(data[frameStart + 7]) << endl;
-
-        cout << "Ŀĵַ:   " << macToStr(data, headerOffset) << endl;
-        cout << "Դַ:     " << macToStr(data, headerOffset + 6) << endl;
-
-        // ֶΣֽ
-        unsigned int et = ((unsigned int)data[headerOffset + 12] << 8) | data[headerOffset + 13];
-        stringstream ss;
-        ss << "0x" << hex << uppercase << setw(4) << setfill('0') << et << dec;
-        cout << "ֶ:   " << ss.str() << endl;
-
-        cout << "ֶγ: " << dec << dataLen << " ֽ" << endl;
-        if (!length_ok) {
-            if (dataLen < ETH_MIN_PAYLOAD) {
-                cout << "쳣: ֶγȹ̣С " << ETH_MIN_PAYLOAD << " ֽڣΪض֡֡" << endl;
-            } else {
-                cout << "쳣: ֶγȹ " << ETH_MAX_PAYLOAD << " ֽڣܰݻ" << endl;
-            }
+        src.fcs = opt.fcs;
+        src.format = capture ? capture->format() : CaptureFormat::Raw;
+        const string indexPath = indexPathFor(opt.path);
+        const long long frames = buildIndexFile(*in, capture.get(), opt, src, indexPath);
+        if (frames < 0) {
+            return 1;
         }
+        cout << "д: " << indexPath << " (" << frames << " ֡)" << endl;
+        return 0;
+    }
 
-        cout << "ֶ(ASCII): " << formatDataAscii(&data[dataStart], dataLen) << endl;
+    CaptureWriter acceptedFile, rejectedFile;
+    if (opt.saveAccepted && !acceptedFile.open(opt.saveAccepted)) {
+        cerr << "޷ļ: " << opt.saveAccepted << endl;
+        return 1;
+    }
+    if (opt.saveRejected && !rejectedFile.open(opt.saveRejected)) {
+        cerr << "޷ļ: " << opt.saveRejected << endl;
+        return 1;
+    }
 
-        // 浱ǰcout״̬Աڴӡʮƺָ
-        ios oldState(nullptr);
-        oldState.copyfmt(cout);
-        cout << "CRCУ(ļ): 0x" << hex << uppercase << setw(2) << setfill('0') << (int)fcs << endl;
-        cout << "CRCУ(): 0x" << hex << uppercase << setw(2) << setfill('0') << (int)calc << endl;
-        cout.copyfmt(oldState); // ָcout״̬
+    ReportOptions ro;
+    ro.format = opt.format;
+    ro.fcs = opt.fcs;
+    ro.frames = !opt.stats;
+    ro.stats = opt.stats;
+    ro.accepted = opt.saveAccepted ? &acceptedFile : nullptr;
+    ro.rejected = opt.saveRejected ? &rejectedFile : nullptr;
+    ro.filter = opt.filtered ? &opt.filter : nullptr;
+    FrameReporter reporter(ro);
 
-        // ״̬ҽCRCƥҳʱ
-        cout << "״̬:       " << ((fcs == calc && length_ok) ? "Accept" : "Reject") << endl;
-        cout << "------------------------------------------" << endl << endl;
+    const auto startTime = chrono::steady_clock::now();
+    int frameCount = runAnalysis(*in, capture.get(), opt, reporter);
 
-        // һǰλü
-        pos = (nextPreamble == total) ? total : nextPreamble;
+    if (opt.stats) {
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        const ByteWindow tail = in->window();
+        TextBuffer& out = threadTextBuffer();
+        (reporter.stats() ? *reporter.stats() : FrameStats()).print(out, tail.base + tail.size, seconds);
+        out.flush();
     }
-
-    if (frameCount == 0) {
-        cout << "δ⵽Ч̫֡" << endl;
+    else if (frameCount == 0) {
+        // ɶʽı׼ֻ¼ʾϢд׼
+        (opt.format == OutputFormat::Text ? cout : cerr) << "δ⵽Ч̫֡" << endl;
+    }
+    if (capture && !capture->error().empty()) {
+        cerr << "ץļʽ: " << capture->error() << endl;
+        return 1;
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,176 @@
+// ʹ fopen ȴͳ CRT 
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "FrameBench.h"
+#include "FrameScanner.h"
+#include "FrameDecoder.h"
+#include "../Common/BenchTimer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief һ׶εĲ
+ */
+struct StageResult {
+    const char* name;
+    const char* kernel; // ý׶ʹõʵ֣ AVX2ûжʵʱΪ "-"
+    double seconds;     // һֵĺʱ
+    uint64_t bytes;     // ý׶δֽ
+    uint64_t frames;    // ý׶δ֡
+};
+
+/**
+ * @brief  analyzeSerial ķʽɨ
+ */
+void scanAll(const unsigned char* data, size_t size, vector<FrameSpan>& spans) {
+    spans.clear();
+    size_t pos = 0;
+    size_t batch = SCAN_BATCH;
+    for (;;) {
+        const size_t end = (size - pos > batch) ? pos + batch : size;
+        const bool atEnd = end == size;
+        const size_t resume = splitFrames(data, end, pos, atEnd, spans);
+        if (atEnd) break;
+        batch = (resume > pos) ? SCAN_BATCH : batch * 2;
+        pos = resume;
+    }
+}
+
+bool readWholeFile(const char* path, vector<unsigned char>& data) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        return false;
+    }
+    unsigned char chunk[64 * 1024];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0) {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+    const bool ok = ferror(fp) == 0;
+    fclose(fp);
+    return ok;
+}
+
+/**
+ * @brief һλСֵ
+ */
+void fixed1(TextBuffer& out, double v, int width) {
+    const uint64_t tenths = (uint64_t)(v * 10 + 0.5);
+    out.dec(tenths / 10, width - 2, ' ').put('.').dec(tenths % 10);
+}
+
+void printStage(TextBuffer& out, const StageResult& r) {
+    out.field(r.name, strlen(r.name), 20).field(r.kernel, strlen(r.kernel), 14);
+    fixed1(out, r.seconds * 1000, 10);
+    fixed1(out, r.seconds > 0 ? (double)r.bytes / r.seconds / (1024 * 1024) : 0, 12);
+    out.dec(r.seconds > 0 ? (uint64_t)((double)r.frames / r.seconds) : 0, 14, ' ').put('\n');
+}
+
+} // namespace
+
+int runBenchmark(const char* path, FcsType fcsType, OutputFormat fmt, unsigned int rounds) {
+    vector<unsigned char> buffer;
+    if (!readWholeFile(path, buffer)) {
+        cerr << "޷ȡļ: " << path << endl;
+        return 1;
+    }
+    const unsigned char* data = buffer.data();
+    const size_t size = buffer.size();
+    if (rounds == 0) rounds = 1;
+
+    // һ飬õ׶ε루ͬʱԤȻ֧Ԥ⣩
+    vector<FrameSpan> spans;
+    scanAll(data, size, spans);
+    vector<FrameInfo> frames;
+    frames.reserve(spans.size());
+    uint64_t spanBytes = 0, fcsBytes = 0, frameBytes = 0;
+    for (const FrameSpan& span : spans) {
+        spanBytes += span.end - span.start;
+        FrameInfo f;
+        if (decodeFrame(data, span, fcsType, f)) {
+            fcsBytes += (uint64_t)(f.payload + f.payloadLen - f.header);
+            frameBytes += f.frameLen;
+            frames.push_back(f);
+        }
+    }
+
+    vector<StageResult> results;
+
+    vector<FrameSpan> scratch;
+    scratch.reserve(spans.size());
+    results.push_back(StageResult{ "ǰɨ", preambleKernelName(),
+        bestOf(rounds, [&]() { scanAll(data, size, scratch); benchSink(scratch.size()); }),
+        size, spans.size() });
+
+    // --fcs=none ʱ֡û FCSУ飬Ҳûһ׶
+    if (fcsType != FcsType::None) {
+        const char* crcName = (fcsType == FcsType::Crc32) ? "֡βУ CRC-32" : "֡βУ CRC-8";
+        results.push_back(StageResult{ crcName, crcKernelName(),
+            bestOf(rounds, [&]() {
+                uint32_t acc = 0;
+                for (const FrameInfo& f : frames) {
+                    acc ^= calcFcs(fcsType, f.header, (size_t)(f.payload + f.payloadLen - f.header));
+                }
+                benchSink(acc);
+            }),
+            fcsBytes, frames.size() });
+    }
+
+    results.push_back(StageResult{ "֡ (У)", "-",
+        bestOf(rounds, [&]() {
+            FrameInfo f;
+            uint64_t acc = 0;
+            for (const FrameSpan& span : spans) {
+                if (decodeFrame(data, span, fcsType, f, false)) acc += f.payloadLen;
+            }
+            benchSink(acc);
+        }),
+        spanBytes, spans.size() });
+
+    const char* formatNames[] = { "ʽ (text)", "ʽ (jsonl)", "ʽ (csv)", "ʽ (bin)" };
+    TextBuffer text;
+    results.push_back(StageResult{ formatNames[(int)fmt], "-",
+        bestOf(rounds, [&]() {
+            text.clear();
+            writeReportHeader(text, fmt, fcsType);
+            int number = 0;
+            for (const FrameInfo& f : frames) {
+                writeFrame(text, fmt, f, ++number, (uint64_t)(f.frame - data), fcsType);
+                if (text.size() >= TextBuffer::FLUSH_SIZE) {
+                    benchSink(text.size());
+                    text.clear(); // ֻʽд
+                }
+            }
+        }),
+        frameBytes, frames.size() });
+
+    double total = 0;
+    for (const StageResult& r : results) {
+        total += r.seconds;
+    }
+
+    const char* rule = "------------------------------------------------------------------------\n";
+    TextBuffer& out = threadTextBuffer();
+    out.put("ܲ: ").put(path).put('\n');
+    out.put(": ").dec((uint64_t)size).put(" ֽ, ").dec((uint64_t)frames.size()).put(" ֡ (ѡ ")
+       .dec((uint64_t)spans.size()).put("); ÿ׶ ").dec(rounds).put(" , ȡһ\n");
+    out.put(rule);
+    out.field("׶", strlen("׶"), 20).field("ʵ", strlen("ʵ"), 14)
+       .put("  ʱ(ms)").put("       MiB/s").put("          ֡/s\n");
+    out.put(rule);
+    for (const StageResult& r : results) {
+        printStage(out, r);
+    }
+    out.put(rule);
+    printStage(out, StageResult{ "ϼ", "-", total, size, frames.size() });
+    out.flush();
+    return 0;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Checksum.h"
+#include "FrameReport.h"
+
+// ------------------ ܲ ------------------
+
+/**
+ * @brief ֽ׶βԭʼ֡ļĴٶȲ
+ *
+ * ļڴ棬֮ÿ׶εʱظ rounds ȡһ֣
+ * ǰɨ (splitFrames)֡βУ (calcFcs)֡ (decodeFrameУ)
+ *  fmt ʽ (writeFrameֻд뻺)
+ * @param path ԭʼ֡ļ·
+ * @param fcsType ֡βУ㷨
+ * @param fmt ʽ׶ʹõʽ
+ * @param rounds ÿ׶εظ
+ * @return ɹ 0ļ޷ȡ 1
+ */
+int runBenchmark(const char* path, FcsType fcsType, OutputFormat fmt, unsigned int rounds);
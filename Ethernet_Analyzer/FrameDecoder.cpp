@@ -0,0 +1,56 @@
+#include "FrameDecoder.h"
+
+namespace {
+
+/**
+ * @brief ֡ͷʼֶΡֶ FCS
+ * @param f  frame / frameLen / header Ľ
+ * @param end ֡ĩβ
+ * @param fcsType ֡βУ㷨
+ * @param checkFcs ǷУ
+ */
+void decodeBody(FrameInfo& f, const unsigned char* end, FcsType fcsType, bool checkFcs) {
+    f.payload = f.header + ETH_HEADER_LEN;
+
+    // FCS λ֡ (CRC-8 Ϊ1ֽڣCRC-32 Ϊ4ֽ)
+    const unsigned char* fcsPos = end - fcsLength(fcsType);
+    f.payloadLen = (size_t)(fcsPos - f.payload);
+    f.lengthOk = f.payloadLen >= ETH_MIN_PAYLOAD && f.payloadLen <= ETH_MAX_PAYLOAD;
+
+    // ֶΣֽ
+    f.etherType = ((unsigned int)f.header[12] << 8) | f.header[13];
+
+    // CRC㷶ΧĿMACֶַĩβFCS
+    f.fcs = readFcs(fcsType, fcsPos);
+    if (checkFcs) {
+        f.calc = calcFcs(fcsType, f.header, (size_t)(fcsPos - f.header));
+    }
+}
+
+} // namespace
+
+bool decodeFrame(const unsigned char* data, const FrameSpan& span, FcsType fcsType, FrameInfo& f, bool checkFcs) {
+    if (!frameSpanValid(span, fcsType)) {
+        return false;
+    }
+    f.frame = data + span.start;
+    f.frameLen = span.end - span.start;
+    f.header = f.frame + PREAMBLE_LEN; // 7xAA + SFDָĿMACַ
+    f.tsSec = 0;
+    f.tsUsec = 0;
+    decodeBody(f, f.frame + f.frameLen, fcsType, checkFcs);
+    return true;
+}
+
+bool decodePacket(const unsigned char* data, const FrameSpan& span, FcsType fcsType, FrameInfo& f, bool checkFcs) {
+    if (!packetSpanValid(span, fcsType)) {
+        return false;
+    }
+    f.frame = data + span.start;
+    f.frameLen = span.end - span.start;
+    f.header = f.frame;
+    f.tsSec = span.tsSec;
+    f.tsUsec = span.tsUsec;
+    decodeBody(f, f.frame + f.frameLen, fcsType, checkFcs);
+    return true;
+}
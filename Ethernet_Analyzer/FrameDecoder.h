@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "FrameScanner.h"
+#include "Checksum.h"
+
+// ------------------ ֡ ------------------
+
+const size_t PREAMBLE_LEN = 8;     // 7ֽǰ + 1ֽ֡ǰ
+const size_t ETH_HEADER_LEN = 14;  // Ŀĵַ + Դַ + ֶ
+const size_t ETH_MIN_PAYLOAD = 46;   //̫СЧغ
+const size_t ETH_MAX_PAYLOAD = 1500; //̫Чغ(Jumbo֡)
+
+/**
+ * @brief һ֡Ľָָ봰еԭʼ
+ */
+struct FrameInfo {
+    const unsigned char* frame;   // ǰһֽڣץļе֡ûǰ룬 header ͬ
+    size_t frameLen;              //  frame  FCS ĩβܳ
+    const unsigned char* header;  // ĿMACַ14ֽ֡ͷʼ
+    const unsigned char* payload; // ֶ
+    size_t payloadLen;            // ֶγ
+    unsigned int etherType;       // ֶΣֽ
+    uint32_t fcs;                 // ļе FCS
+    uint32_t calc;                // õ FCS
+    bool lengthOk;                // ֶγǷ [ETH_MIN_PAYLOAD, ETH_MAX_PAYLOAD] 
+    uint32_t tsSec;               // ץʱ룩ԭʼ֡ļΪ0
+    uint32_t tsUsec;              // ץʱ΢벿
+
+    /**
+     * @brief ֡Ƿǰ루ԭʼ֡ļУץļûУ
+     */
+    bool hasPreamble() const {
+        return frame != header;
+    }
+
+    /**
+     * @brief ҽCRCƥҳʱ
+     */
+    bool accepted() const {
+        return fcs == calc && lengthOk;
+    }
+};
+
+/**
+ * @brief ж֡Ƿ֡ͷ FCSĿȲΪһ֡
+ */
+inline bool frameSpanValid(const FrameSpan& span, FcsType fcsType) {
+    return span.end >= span.start + PREAMBLE_LEN + ETH_HEADER_LEN + fcsLength(fcsType);
+}
+
+/**
+ * @brief һ֡һǰ루ĩβ֮ǰ FCS ֽΪ֡βУ
+ * @param data 
+ * @param span ֡ڴеķΧ
+ * @param fcsType ֡βУ㷨
+ * @param f 
+ * @param checkFcs Ϊ false ʱ calc֮ checkFrameFcs 
+ * @return ȲԹһ֡ʱ false
+ */
+bool decodeFrame(const unsigned char* data, const FrameSpan& span, FcsType fcsType, FrameInfo& f,
+                 bool checkFcs = true);
+
+/**
+ * @brief жץ¼Ƿ֡ͷ FCS
+ */
+inline bool packetSpanValid(const FrameSpan& span, FcsType fcsType) {
+    return span.end >= span.start + ETH_HEADER_LEN + fcsLength(fcsType);
+}
+
+/**
+ * @brief ץļеһ֡¼ݴĿĵַʼûǰ룬FCSУλĩβ
+ * @param data 
+ * @param span ¼ڴеķΧʱ
+ * @param fcsType ֡βУ㷨
+ * @param f 
+ * @param checkFcs Ϊ false ʱ calc֮ checkFrameFcs 
+ * @return ¼Թһ֡ʱ false
+ */
+bool decodePacket(const unsigned char* data, const FrameSpan& span, FcsType fcsType, FrameInfo& f,
+                  bool checkFcs = true);
+
+/**
+ * @brief Ϊ checkFcs = false ֡У
+ */
+inline void checkFrameFcs(FrameInfo& f, FcsType fcsType) {
+    f.calc = calcFcs(fcsType, f.header, (size_t)(f.payload + f.payloadLen - f.header));
+}
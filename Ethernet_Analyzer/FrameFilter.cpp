@@ -0,0 +1,486 @@
+#include "FrameFilter.h"
+#include "../Common/ProtocolViews.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+//  "!" Ƕȣֹαʽľջռ
+const int MAX_DEPTH = 64;
+
+/**
+ * @brief ֶεȡֵֵͣȽ
+ */
+enum class ValueKind { Number, Mac, Ipv4, Status };
+
+struct FieldInfo {
+    const char* name;
+    FilterField field;
+    ValueKind kind;
+};
+
+const FieldInfo FIELDS[] = {
+    { "index", FilterField::Index, ValueKind::Number },
+    { "offset", FilterField::Offset, ValueKind::Number },
+    { "dst", FilterField::Dst, ValueKind::Mac },
+    { "src", FilterField::Src, ValueKind::Mac },
+    { "ethertype", FilterField::EtherType, ValueKind::Number },
+    { "type", FilterField::EtherType, ValueKind::Number },
+    { "len", FilterField::Len, ValueKind::Number },
+    { "payload_len", FilterField::Len, ValueKind::Number },
+    { "frame_len", FilterField::FrameLen, ValueKind::Number },
+    { "fcs", FilterField::Fcs, ValueKind::Number },
+    { "calc", FilterField::Calc, ValueKind::Number },
+    { "status", FilterField::Status, ValueKind::Status },
+    { "vlan", FilterField::Vlan, ValueKind::Number },
+    { "ip_src", FilterField::IpSrc, ValueKind::Ipv4 },
+    { "ip_dst", FilterField::IpDst, ValueKind::Ipv4 },
+    { "ip_proto", FilterField::IpProto, ValueKind::Number },
+    { "ttl", FilterField::Ttl, ValueKind::Number },
+    { "sport", FilterField::Sport, ValueKind::Number },
+    { "dport", FilterField::Dport, ValueKind::Number },
+    { "port", FilterField::Port, ValueKind::Number },
+    { "tcp_flags", FilterField::TcpFlags, ValueKind::Number },
+    { "icmp_type", FilterField::IcmpType, ValueKind::Number },
+    { "arp_op", FilterField::ArpOp, ValueKind::Number },
+};
+
+struct NamedValue {
+    const char* name;
+    uint64_t value;
+};
+
+const NamedValue PROTOCOLS[] = {
+    { "vlan", (uint64_t)FilterField::HasVlan }, { "arp", (uint64_t)FilterField::HasArp },
+    { "ipv4", (uint64_t)FilterField::HasIpv4 }, { "ipv6", (uint64_t)FilterField::HasIpv6 },
+    { "ip", (uint64_t)FilterField::HasIp },     { "tcp", (uint64_t)FilterField::HasTcp },
+    { "udp", (uint64_t)FilterField::HasUdp },   { "icmp", (uint64_t)FilterField::HasIcmp },
+};
+
+const NamedValue ETHER_TYPES[] = {
+    { "ipv4", ETH_TYPE_IPV4 }, { "arp", ETH_TYPE_ARP }, { "rarp", 0x8035 }, { "vlan", ETH_TYPE_VLAN },
+    { "qinq", ETH_TYPE_QINQ }, { "ipv6", ETH_TYPE_IPV6 }, { "lldp", 0x88CC },
+};
+
+const NamedValue IP_PROTOCOLS[] = {
+    { "icmp", IP_PROTO_ICMP }, { "igmp", 2 }, { "tcp", IP_PROTO_TCP }, { "udp", IP_PROTO_UDP },
+    { "gre", 47 }, { "icmpv6", IP_PROTO_ICMPV6 }, { "sctp", 132 },
+};
+
+bool equalsIgnoreCase(const string& a, const char* b) {
+    size_t i = 0;
+    for (; i < a.size() && b[i]; ++i) {
+        if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i])) return false;
+    }
+    return i == a.size() && b[i] == '\0';
+}
+
+template <size_t N>
+bool lookupName(const NamedValue (&table)[N], const string& name, uint64_t& value) {
+    for (const NamedValue& e : table) {
+        if (equalsIgnoreCase(name, e.name)) {
+            value = e.value;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline uint64_t packMac(const uint8_t* a) {
+    return ((uint64_t)a[0] << 40) | ((uint64_t)a[1] << 32) | ((uint64_t)a[2] << 24) |
+           ((uint64_t)a[3] << 16) | ((uint64_t)a[4] << 8) | (uint64_t)a[5];
+}
+
+/**
+ * @brief ʮƻ 0x ͷʮǰ԰ʮƣ˽
+ */
+bool parseNumber(const string& s, uint64_t& v) {
+    if (s.empty() || !isdigit((unsigned char)s[0])) return false;
+    const bool hex = s.size() > 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X');
+    if (hex && !isxdigit((unsigned char)s[2])) return false; // strtoull հ
+    char* end = nullptr;
+    v = strtoull(s.c_str() + (hex ? 2 : 0), &end, hex ? 16 : 10);
+    return *end == '\0';
+}
+
+/**
+ * @brief  "12-34-56-78-9A-BC"  "12:34:56:78:9a:bc"
+ */
+bool parseMac(const string& s, uint64_t& v) {
+    if (s.size() != 17) return false;
+    v = 0;
+    for (size_t i = 0; i < 17; ++i) {
+        const char c = s[i];
+        if (i % 3 == 2) {
+            if (c != '-' && c != ':') return false;
+            continue;
+        }
+        if (!isxdigit((unsigned char)c)) return false;
+        v = (v << 4) | (uint64_t)(isdigit((unsigned char)c) ? c - '0' : (tolower((unsigned char)c) - 'a' + 10));
+    }
+    return true;
+}
+
+bool parseIpv4(const string& s, uint64_t& v) {
+    v = 0;
+    const char* p = s.c_str();
+    for (int i = 0; i < 4; ++i) {
+        if (!isdigit((unsigned char)*p)) return false;
+        char* end = nullptr;
+        const unsigned long part = strtoul(p, &end, 10);
+        if (part > 255 || end - p > 3) return false;
+        v = (v << 8) | part;
+        p = end;
+        if (i < 3 && *p++ != '.') return false;
+    }
+    return *p == '\0';
+}
+
+} // namespace
+
+// ------------------ ﷨ ------------------
+
+/**
+ * @brief ʷ + ݹ½﷨ֱνڵ
+ */
+class FrameFilter::Parser {
+public:
+    Parser(FrameFilter& f, const string& text) : filter(f), src(text) {
+    }
+
+    bool run() {
+        if (!next()) return false;
+        if (tok.kind == Tok::End) return fail("ʽΪ");
+        int node;
+        if (!parseOr(node, 0)) return false;
+        if (tok.kind != Tok::End) return fail("");
+        filter.root = node;
+        return true;
+    }
+
+private:
+    enum class Tok { Word, Cmp, And, Or, Not, LParen, RParen, End };
+
+    struct Token {
+        Tok kind;
+        string text;
+        Op cmp;
+        size_t pos;
+    };
+
+    bool fail(const char* msg) {
+        filter.err = string(msg) + "λ " + to_string(tok.pos + 1) + (tok.kind == Tok::End ? "ʽĩβ" : "\"" + tok.text + "\"");
+        return false;
+    }
+
+    /**
+     * @brief ȡһǺ
+     */
+    bool next() {
+        while (pos < src.size() && isspace((unsigned char)src[pos])) ++pos;
+        tok = Token{ Tok::End, string(), Op::Eq, pos };
+        if (pos >= src.size()) return true;
+
+        static const struct { const char* text; Tok kind; Op cmp; } SYMBOLS[] = {
+            { "&&", Tok::And, Op::And }, { "||", Tok::Or, Op::Or }, { "==", Tok::Cmp, Op::Eq },
+            { "!=", Tok::Cmp, Op::Ne }, { "<=", Tok::Cmp, Op::Le }, { ">=", Tok::Cmp, Op::Ge },
+            { "<", Tok::Cmp, Op::Lt }, { ">", Tok::Cmp, Op::Gt }, { "!", Tok::Not, Op::Not },
+            { "(", Tok::LParen, Op::And }, { ")", Tok::RParen, Op::And },
+        };
+        for (const auto& s : SYMBOLS) {
+            const size_t n = strlen(s.text);
+            if (src.compare(pos, n, s.text) == 0) {
+                tok.kind = s.kind;
+                tok.cmp = s.cmp;
+                tok.text = s.text;
+                pos += n;
+                return true;
+            }
+        }
+
+        const size_t start = pos;
+        while (pos < src.size() && (isalnum((unsigned char)src[pos]) || strchr("_.:-", src[pos]))) ++pos;
+        if (pos == start) {
+            tok.kind = Tok::Word;
+            tok.text = src.substr(pos, 1);
+            return fail("޷ʶַ");
+        }
+        tok.text = src.substr(start, pos - start);
+        if (equalsIgnoreCase(tok.text, "and")) tok.kind = Tok::And;
+        else if (equalsIgnoreCase(tok.text, "or")) tok.kind = Tok::Or;
+        else if (equalsIgnoreCase(tok.text, "not")) tok.kind = Tok::Not;
+        else tok.kind = Tok::Word;
+        return true;
+    }
+
+    int add(Op op, FilterField field, uint64_t value, int left, int right) {
+        filter.nodes.push_back(Node{ op, field, value, left, right });
+        return (int)filter.nodes.size() - 1;
+    }
+
+    bool parseOr(int& node, int depth) {
+        if (!parseAnd(node, depth)) return false;
+        while (tok.kind == Tok::Or) {
+            int right;
+            if (!next() || !parseAnd(right, depth)) return false;
+            node = add(Op::Or, FilterField::Index, 0, node, right);
+        }
+        return true;
+    }
+
+    bool parseAnd(int& node, int depth) {
+        if (!parseUnary(node, depth)) return false;
+        while (tok.kind == Tok::And) {
+            int right;
+            if (!next() || !parseUnary(right, depth)) return false;
+            node = add(Op::And, FilterField::Index, 0, node, right);
+        }
+        return true;
+    }
+
+    bool parseUnary(int& node, int depth) {
+        if (depth > MAX_DEPTH) return fail("Ƕײ");
+        if (tok.kind == Tok::Not) {
+            int child;
+            if (!next() || !parseUnary(child, depth + 1)) return false;
+            node = add(Op::Not, FilterField::Index, 0, child, -1);
+            return true;
+        }
+        if (tok.kind == Tok::LParen) {
+            if (!next() || !parseOr(node, depth + 1)) return false;
+            if (tok.kind != Tok::RParen) return fail("ȱ \")\"");
+            return next();
+        }
+        if (tok.kind != Tok::Word) return fail("˴ӦΪֶЭ");
+
+        const Token name = tok;
+        if (!next()) return false;
+        if (tok.kind != Tok::Cmp) {
+            // Э֡киò
+            uint64_t layer;
+            if (!lookupName(PROTOCOLS, name.text, layer)) {
+                tok = name;
+                return fail("δ֪ЭֶκȱٱȽ");
+            }
+            node = add(Op::Has, (FilterField)layer, 0, -1, -1);
+            return true;
+        }
+        const FieldInfo* field = nullptr;
+        for (const FieldInfo& fi : FIELDS) {
+            if (equalsIgnoreCase(name.text, fi.name)) field = &fi;
+        }
+        if (!field) {
+            tok = name;
+            return fail("δֶ֪");
+        }
+        const Op op = tok.cmp;
+        if (!next()) return false;
+        if (tok.kind != Tok::Word) return fail("˴ӦΪȽϵֵ");
+        uint64_t value = 0;
+        if (!parseValue(*field, tok.text, value)) return fail("ֵֶͲ");
+        if (field->field == FilterField::Fcs || field->field == FilterField::Calc || field->field == FilterField::Status) {
+            filter.fcsNeeded = true;
+        }
+        node = add(op, field->field, value, -1, -1);
+        return next();
+    }
+
+    bool parseValue(const FieldInfo& field, const string& text, uint64_t& value) {
+        switch (field.kind) {
+        case ValueKind::Mac:
+            return parseMac(text, value);
+        case ValueKind::Ipv4:
+            return parseIpv4(text, value);
+        case ValueKind::Status:
+            if (equalsIgnoreCase(text, "accept")) value = 1;
+            else if (equalsIgnoreCase(text, "reject")) value = 0;
+            else return false;
+            return true;
+        default:
+            if (parseNumber(text, value)) return true;
+            if (field.field == FilterField::EtherType) return lookupName(ETHER_TYPES, text, value);
+            if (field.field == FilterField::IpProto) return lookupName(IP_PROTOCOLS, text, value);
+            return false;
+        }
+    }
+
+    FrameFilter& filter;
+    const string& src;
+    size_t pos = 0;
+    Token tok;
+};
+
+bool FrameFilter::compile(const string& expr) {
+    nodes.clear();
+    root = -1;
+    fcsNeeded = false;
+    err.clear();
+    Parser parser(*this, expr);
+    if (!parser.run()) {
+        nodes.clear();
+        root = -1;
+        return false;
+    }
+    return true;
+}
+
+// ------------------ ֵ ------------------
+
+/**
+ * @brief һֵ֡ģϲЭڵһαʱʶ
+ */
+class FrameFilter::Context {
+public:
+    Context(const FrameInfo& frame, int n, uint64_t off) : f(frame), number(n), offset(off) {
+    }
+
+    const PacketLayers& layers() {
+        if (!layersDone) {
+            decodeLayers((uint16_t)f.etherType, f.payload, f.payloadLen, packet);
+            layersDone = true;
+        }
+        return packet;
+    }
+
+    /**
+     * @brief ȡֶεֵ
+     * @return ֡ûиֶڵĲʱ false
+     */
+    bool value(FilterField field, uint64_t& v) {
+        switch (field) {
+        case FilterField::Index:     v = (uint64_t)number; return true;
+        case FilterField::Offset:    v = offset; return true;
+        case FilterField::Dst:       v = packMac(f.header); return true;
+        case FilterField::Src:       v = packMac(f.header + 6); return true;
+        case FilterField::EtherType: v = f.etherType; return true;
+        case FilterField::Len:       v = f.payloadLen; return true;
+        case FilterField::FrameLen:  v = f.frameLen - (size_t)(f.header - f.frame); return true;
+        case FilterField::Fcs:       v = f.fcs; return true;
+        case FilterField::Calc:      v = f.calc; return true;
+        case FilterField::Status:    v = f.accepted() ? 1 : 0; return true;
+        default: break;
+        }
+
+        const PacketLayers& l = layers();
+        switch (field) {
+        case FilterField::Vlan:
+            if (l.vlanCount == 0) return false;
+            v = l.vlans[l.vlanCount - 1].vlanId(); // ڲǩ
+            return true;
+        case FilterField::IpSrc:
+            //  CSV  ip_src һ£ARP ֡ȡͷЭַ
+            if (l.ipv4.valid()) v = l.ipv4.srcAddr();
+            else if (l.arp.valid() && l.arp.isEthernetIpv4()) v = readBE32(l.arp.senderProtocol());
+            else return false;
+            return true;
+        case FilterField::IpDst:
+            if (l.ipv4.valid()) v = l.ipv4.dstAddr();
+            else if (l.arp.valid() && l.arp.isEthernetIpv4()) v = readBE32(l.arp.targetProtocol());
+            else return false;
+            return true;
+        case FilterField::IpProto:
+            if (!l.ipv4.valid() && !l.ipv6.valid()) return false;
+            v = l.ipProto;
+            return true;
+        case FilterField::Ttl:
+            if (l.ipv4.valid()) v = l.ipv4.ttl();
+            else if (l.ipv6.valid()) v = l.ipv6.hopLimit();
+            else return false;
+            return true;
+        case FilterField::Sport:
+            if (l.tcp.valid()) v = l.tcp.srcPort();
+            else if (l.udp.valid()) v = l.udp.srcPort();
+            else return false;
+            return true;
+        case FilterField::Dport:
+            if (l.tcp.valid()) v = l.tcp.dstPort();
+            else if (l.udp.valid()) v = l.udp.dstPort();
+            else return false;
+            return true;
+        case FilterField::TcpFlags:
+            if (!l.tcp.valid()) return false;
+            v = l.tcp.flags();
+            return true;
+        case FilterField::IcmpType:
+            if (!l.icmp.valid()) return false;
+            v = l.icmp.type();
+            return true;
+        case FilterField::ArpOp:
+            if (!l.arp.valid()) return false;
+            v = l.arp.opcode();
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * @brief ĳһǷ
+     */
+    bool has(FilterField layer) {
+        const PacketLayers& l = layers();
+        switch (layer) {
+        case FilterField::HasVlan: return l.vlanCount > 0;
+        case FilterField::HasArp:  return l.arp.valid();
+        case FilterField::HasIpv4: return l.ipv4.valid();
+        case FilterField::HasIpv6: return l.ipv6.valid();
+        case FilterField::HasIp:   return l.ipv4.valid() || l.ipv6.valid();
+        case FilterField::HasTcp:  return l.tcp.valid();
+        case FilterField::HasUdp:  return l.udp.valid();
+        case FilterField::HasIcmp: return l.icmp.valid();
+        default:                   return false;
+        }
+    }
+
+private:
+    const FrameInfo& f;
+    int number;
+    uint64_t offset;
+    bool layersDone = false;
+    PacketLayers packet;
+};
+
+namespace {
+
+inline bool compare(uint64_t a, int op, uint64_t b) {
+    switch (op) {
+    case 0:  return a == b;
+    case 1:  return a != b;
+    case 2:  return a < b;
+    case 3:  return a <= b;
+    case 4:  return a > b;
+    default: return a >= b;
+    }
+}
+
+} // namespace
+
+bool FrameFilter::eval(int index, Context& ctx) const {
+    const Node& n = nodes[(size_t)index];
+    switch (n.op) {
+    case Op::And: return eval(n.left, ctx) && eval(n.right, ctx);
+    case Op::Or:  return eval(n.left, ctx) || eval(n.right, ctx);
+    case Op::Not: return !eval(n.left, ctx);
+    case Op::Has: return ctx.has(n.field);
+    default: break;
+    }
+    const int cmp = (int)n.op - (int)Op::Eq;
+    uint64_t v;
+    if (n.field == FilterField::Port) {
+        return (ctx.value(FilterField::Sport, v) && compare(v, cmp, n.value)) ||
+               (ctx.value(FilterField::Dport, v) && compare(v, cmp, n.value));
+    }
+    return ctx.value(n.field, v) && compare(v, cmp, n.value);
+}
+
+bool FrameFilter::matches(const FrameInfo& f, int number, uint64_t offset) const {
+    if (root < 0) {
+        return true;
+    }
+    Context ctx(f, number, offset);
+    return eval(root, ctx);
+}
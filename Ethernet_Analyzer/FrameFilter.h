@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "FrameDecoder.h"
+
+// ------------------ ֡˱ʽ ------------------
+// ﷨ȼӵ͵ߣ
+//   expr    := and ( ("||" | "or") and )*
+//   and     := unary ( ("&&" | "and") unary )*
+//   unary   := ("!" | "not") unary | "(" expr ")" | ֶ ȽϷ ֵ | Э
+//   ȽϷ  := == != < <= > >=
+// ֶΣindex offset dst src ethertype len frame_len fcs calc status
+//       vlan ip_src ip_dst ip_proto ttl sport dport port tcp_flags icmp_type arp_op
+// Эʱʾ֡киò㣩vlan arp ipv4 ipv6 ip tcp udp icmp
+// ֵʮƻ 0x ʮMAC ַ (12-34-56-78-9A-BC  12:34:...) IPv4 ַ
+//     Accept / Rejectstatusֶ (ipv4 arp ipv6 vlan ...)Э (tcp udp icmp ...)
+// ֡ûֶڵĲʱ TCP/UDP ֡ sportκαȽ϶
+// ip_src / ip_dst ֻ IPv4 ַȽϣARP ֡Ϊͷ / ĿЭַport ʾ sport  dport һ㡣
+
+/**
+ * @brief ˱ʽпõ֡
+ */
+enum class FilterField {
+    Index, Offset, Dst, Src, EtherType, Len, FrameLen, Fcs, Calc, Status,
+    Vlan, IpSrc, IpDst, IpProto, Ttl, Sport, Dport, Port, TcpFlags, IcmpType, ArpOp,
+    // ֻʾĳһǷ
+    HasVlan, HasArp, HasIpv4, HasIpv6, HasIp, HasTcp, HasUdp, HasIcmp
+};
+
+/**
+ * @brief Ĺ˱ʽһΣ֮ÿֵ֡
+ *
+ * ʽΪڵʾνֵʱֻ㱻õֶΣϲЭֻ
+ * ֶʱʶÿ֡ʶһΣδ fcs / calc / status ʱҪУ롣
+ * ֵ޸Ķ󣬿ڶ߳ͬʱʹá
+ */
+class FrameFilter {
+public:
+    /**
+     * @brief ʽ
+     * @return ﷨󷵻 false error()
+     */
+    bool compile(const std::string& expr);
+
+    const std::string& error() const {
+        return err;
+    }
+
+    /**
+     * @brief ʽǷУֶ (fcscalcstatus)
+     */
+    bool usesFcs() const {
+        return fcsNeeded;
+    }
+
+    /**
+     * @brief жһ֡Ƿʽ
+     * @param f ֡ usesFcs() Ϊ falseԲе calc
+     * @param number ֡ţ1ʼ
+     * @param offset ֡еƫ
+     */
+    bool matches(const FrameInfo& f, int number, uint64_t offset) const;
+
+private:
+    enum class Op : uint8_t { And, Or, Not, Has, Eq, Ne, Lt, Le, Gt, Ge };
+
+    /**
+     * @brief νĽڵ㣻ӽڵ±
+     */
+    struct Node {
+        Op op;
+        FilterField field; // Ƚϻ Has ڵֶ
+        uint64_t value;    // Ƚϵֵ
+        int left;          // And / Or / Not ӽڵ
+        int right;
+    };
+
+    class Parser;
+    class Context;
+
+    bool eval(int node, Context& ctx) const;
+
+    std::vector<Node> nodes;
+    int root = -1;
+    bool fcsNeeded = false;
+    std::string err;
+};
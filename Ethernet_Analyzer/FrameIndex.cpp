@@ -0,0 +1,288 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "FrameIndex.h"
+#include "FrameReport.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+const char INDEX_MAGIC[4] = { 'E', 'A', 'I', 'X' };
+
+inline uint64_t rdLE(const unsigned char* p, int bytes) {
+    uint64_t v = 0;
+    for (int i = bytes - 1; i >= 0; --i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+/**
+ * @brief ׷޷ LEB128 䳤
+ */
+void putVarint(TextBuffer& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.put((char)(v | 0x80));
+        v >>= 7;
+    }
+    out.put((char)v);
+}
+
+/**
+ * @brief ȡ޷ LEB128 䳤
+ * @return ݲ򳬹10ֽʱ false
+ */
+bool getVarint(const unsigned char*& p, const unsigned char* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 70 && p < end; shift += 7) {
+        const unsigned char b = *p++;
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if ((b & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+inline uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+inline int64_t unzigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+} // namespace
+
+bool statSource(const char* path, IndexSource& src) {
+#ifdef _WIN32
+    // _stat64 ޸ʱֻȷ룬FILETIME ȷ 100 룻· CreateFileA һ ANSI ҳ
+    const int len = MultiByteToWideChar(CP_ACP, 0, path, -1, nullptr, 0);
+    if (len <= 0) {
+        return false;
+    }
+    vector<wchar_t> wide((size_t)len);
+    MultiByteToWideChar(CP_ACP, 0, path, -1, wide.data(), len);
+    WIN32_FILE_ATTRIBUTE_DATA attr;
+    if (!GetFileAttributesExW(wide.data(), GetFileExInfoStandard, &attr) ||
+        (attr.dwFileAttributes & (FILE_ATTRIBUTE_DIRECTORY | FILE_ATTRIBUTE_DEVICE)) != 0) {
+        return false;
+    }
+    const uint64_t ticks = ((uint64_t)attr.ftLastWriteTime.dwHighDateTime << 32) | attr.ftLastWriteTime.dwLowDateTime;
+    src.size = ((uint64_t)attr.nFileSizeHigh << 32) | attr.nFileSizeLow;
+    src.mtime = ((int64_t)ticks - 116444736000000000LL) * 100; // 1601 100 Ϊ1970
+#else
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+    src.size = (uint64_t)st.st_size;
+    src.mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+    return true;
+}
+
+string indexPathFor(const char* path) {
+    return string(path) + ".idx";
+}
+
+bool readAt(FILE* fp, uint64_t offset, size_t len, vector<unsigned char>& buf) {
+#ifdef _WIN32
+    if (_fseeki64(fp, (long long)offset, SEEK_SET) != 0) return false;
+#else
+    if (fseeko(fp, (off_t)offset, SEEK_SET) != 0) return false;
+#endif
+    buf.resize(len);
+    return fread(buf.data(), 1, len, fp) == len;
+}
+
+// ------------------ д ------------------
+
+FrameIndexWriter::~FrameIndexWriter() {
+    if (fp) {
+        fclose(fp);
+        remove(tempPath.c_str()); // δɵ
+    }
+}
+
+bool FrameIndexWriter::open(const string& path, const IndexSource& src) {
+    finalPath = path;
+    tempPath = path + ".tmp";
+    source = src;
+    fp = fopen(tempPath.c_str(), "wb");
+    if (!fp) {
+        return false;
+    }
+    // дռλļͷfinish() ʱٻ
+    char zero[INDEX_HEADER_SIZE] = { 0 };
+    failed = fwrite(zero, 1, sizeof(zero), fp) != sizeof(zero);
+    return !failed;
+}
+
+void FrameIndexWriter::appendEntry(TextBuffer& out, const FrameInfo& f, uint64_t offset) {
+    IndexEntry e;
+    e.offset = offset;
+    e.length = (uint32_t)f.frameLen;
+    e.etherType = (uint16_t)f.etherType;
+    e.flags = (uint8_t)((f.accepted() ? FRAME_FLAG_ACCEPTED : 0) |
+                        (f.fcs == f.calc ? FRAME_FLAG_FCS_OK : 0) |
+                        (f.lengthOk ? FRAME_FLAG_LENGTH_OK : 0));
+    e.reserved = 0;
+    e.tsSec = f.tsSec;
+    e.tsUsec = f.tsUsec;
+    out.put((const char*)&e, sizeof(e));
+}
+
+void FrameIndexWriter::write(TextBuffer& entries) {
+    const bool withTime = source.format != CaptureFormat::Raw;
+    for (size_t pos = 0; pos + sizeof(IndexEntry) <= entries.size(); pos += sizeof(IndexEntry)) {
+        IndexEntry e;
+        memcpy(&e, entries.data() + pos, sizeof(e));
+
+        if (frames % INDEX_CHECKPOINT_INTERVAL == 0) {
+            // 㴦0ʼѯʱļ¼
+            checkpoints.push_back(Checkpoint{ e.offset, position + stream.size() });
+            prevEnd = e.offset;
+            prevSec = 0;
+        }
+        putVarint(stream, e.offset - prevEnd);
+        putVarint(stream, e.length);
+        stream.le(e.etherType, 2).put((char)e.flags);
+        if (withTime) {
+            putVarint(stream, zigzag((int64_t)e.tsSec - (int64_t)prevSec));
+            putVarint(stream, e.tsUsec);
+            prevSec = e.tsSec;
+        }
+        prevEnd = e.offset + e.length;
+        ++frames;
+    }
+    entries.clear();
+
+    if (fp && !stream.empty()) {
+        failed |= fwrite(stream.data(), 1, stream.size(), fp) != stream.size();
+        position += stream.size();
+        stream.clear();
+    }
+}
+
+bool FrameIndexWriter::finish() {
+    if (!fp) {
+        return false;
+    }
+    TextBuffer tail(checkpoints.size() * 16 + INDEX_HEADER_SIZE);
+    for (const Checkpoint& c : checkpoints) {
+        tail.le(c.offset, 8).le(c.position, 8);
+    }
+    failed |= fwrite(tail.data(), 1, tail.size(), fp) != tail.size();
+
+    TextBuffer header(INDEX_HEADER_SIZE);
+    header.put(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.le(INDEX_VERSION, 2).le(INDEX_CHECKPOINT_INTERVAL, 2);
+    header.le(source.size, 8).le((uint64_t)source.mtime, 8);
+    header.le(frames, 8).le(position, 8);
+    header.put((char)source.fcs).put((char)source.format);
+    header.fill('\0', INDEX_HEADER_SIZE - header.size());
+    failed |= fseek(fp, 0, SEEK_SET) != 0;
+    failed |= fwrite(header.data(), 1, header.size(), fp) != header.size();
+    failed |= fclose(fp) != 0;
+    fp = nullptr;
+
+    if (failed) {
+        remove(tempPath.c_str());
+        return false;
+    }
+    remove(finalPath.c_str()); // Windows  rename Ḳļ
+    if (rename(tempPath.c_str(), finalPath.c_str()) != 0) {
+        remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// ------------------ ѯ ------------------
+
+bool FrameIndex::open(const string& path) {
+    file = openInput(path.c_str());
+    if (!file) {
+        return false;
+    }
+    // ӳļڼļ˵ʱȫ
+    while (!file->window().eof) {
+        file->refill(0);
+    }
+    const ByteWindow win = file->window();
+    data = win.data;
+    size = win.size;
+    if (size < INDEX_HEADER_SIZE || memcmp(data, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+        rdLE(data + 4, 2) != INDEX_VERSION) {
+        return false;
+    }
+    interval = (uint16_t)rdLE(data + 6, 2);
+    sourceSize = rdLE(data + 8, 8);
+    sourceMtime = (int64_t)rdLE(data + 16, 8);
+    frames = rdLE(data + 24, 8);
+    checkpointPos = rdLE(data + 32, 8);
+    fcs = (FcsType)data[40];
+    captureFormat = (CaptureFormat)data[41];
+
+    // ǡλļĩβ
+    const uint64_t checkpoints = interval ? (frames + interval - 1) / interval : 0;
+    return interval != 0 && checkpointPos >= INDEX_HEADER_SIZE && checkpointPos <= size &&
+           (size - checkpointPos) == checkpoints * 16;
+}
+
+bool FrameIndex::matches(const IndexSource& src) const {
+    return data != nullptr && src.size == sourceSize && src.mtime == sourceMtime &&
+           src.fcs == fcs && src.format == captureFormat;
+}
+
+bool FrameIndex::lookup(uint64_t number, IndexEntry& e) const {
+    if (number == 0 || number > frames) {
+        return false;
+    }
+    const uint64_t i = number - 1;
+    const unsigned char* cp = data + checkpointPos + (i / interval) * 16;
+    uint64_t prevEnd = rdLE(cp, 8);
+    const uint64_t pos = rdLE(cp + 8, 8);
+    if (pos < INDEX_HEADER_SIZE || pos >= checkpointPos) {
+        return false;
+    }
+    const unsigned char* p = data + pos;
+    const unsigned char* end = data + checkpointPos;
+    const bool withTime = captureFormat != CaptureFormat::Raw;
+    uint32_t prevSec = 0;
+
+    for (uint64_t k = 0; k <= i % interval; ++k) {
+        uint64_t delta, length;
+        if (!getVarint(p, end, delta) || !getVarint(p, end, length) || end - p < 3) {
+            return false;
+        }
+        e.offset = prevEnd + delta;
+        e.length = (uint32_t)length;
+        e.etherType = (uint16_t)rdLE(p, 2);
+        e.flags = p[2];
+        e.reserved = 0;
+        p += 3;
+        e.tsSec = 0;
+        e.tsUsec = 0;
+        if (withTime) {
+            uint64_t sec, usec;
+            if (!getVarint(p, end, sec) || !getVarint(p, end, usec)) {
+                return false;
+            }
+            e.tsSec = (uint32_t)((int64_t)prevSec + unzigzag(sec));
+            e.tsUsec = (uint32_t)usec;
+            prevSec = e.tsSec;
+        }
+        prevEnd = e.offset + e.length;
+    }
+    return true;
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "InputSource.h"
+#include "Checksum.h"
+#include "CaptureFile.h"
+#include "FrameDecoder.h"
+#include "../Common/TextBuffer.h"
+
+// ------------------ ֡ ------------------
+// ļΪ֡ļ· ".idx"ΪС
+//   ļͷ (64ֽ): magic "EAIX" | u16 汾 | u16  K | u64 ԴļС | i64 Դļ޸ʱ ()
+//                    | u64 ֡ | u64 λ | u8 У㷨 | u8 ʽ | 22ֽڱ
+//   ֡¼: ÿ֡Ϊ varint(ʼƫ - һ֡ĩβ) | varint() | u16 ֶ | u8 ־ (FRAME_FLAG_*)
+//             ץļ zigzag varint(ʱ - һ֡ʱ) | varint(΢)
+//   : ÿ K ֡һ (u64 ֡ʼƫ | u64 ֡¼ļеλ)ÿ㴦´0ʼ
+// ѯ N ֻ֡ҵ (N-1)/K벻 K-1 ¼
+
+const uint16_t INDEX_VERSION = 2;
+const uint16_t INDEX_CHECKPOINT_INTERVAL = 64;
+const size_t INDEX_HEADER_SIZE = 64;
+
+/**
+ * @brief һ֡
+ */
+struct IndexEntry {
+    uint64_t offset;    // ֡Դļеʼƫƣԭʼ֡Ϊǰ룬ץļΪ֡ͷ
+    uint32_t length;    // ֡ȵĳ
+    uint16_t etherType; // ֶ
+    uint8_t flags;      // FRAME_FLAG_* 
+    uint8_t reserved;
+    uint32_t tsSec;     // ץʱ
+    uint32_t tsUsec;
+};
+
+/**
+ * @brief ʱԴļԣļͷһʱʧЧ
+ */
+struct IndexSource {
+    uint64_t size = 0;
+    int64_t mtime = 0; // ޸ʱ䣬1970
+    FcsType fcs = FcsType::Crc8;
+    CaptureFormat format = CaptureFormat::Raw;
+};
+
+/**
+ * @brief ȡļĴС޸ʱ
+ *
+ * ޸ʱ䱣µĲ֣ͬһڸдΪͬСļֻȽΪȻЧ
+ * @return ļڻͨļʱ false
+ */
+bool statSource(const char* path, IndexSource& src);
+
+/**
+ * @brief ֡ļӦļ·
+ */
+std::string indexPathFor(const char* path);
+
+/**
+ * @brief д룺֡˳룬дʱļfinish() ɹ滻ʽļ
+ */
+class FrameIndexWriter {
+public:
+    FrameIndexWriter() = default;
+    FrameIndexWriter(const FrameIndexWriter&) = delete;
+    FrameIndexWriter& operator=(const FrameIndexWriter&) = delete;
+    ~FrameIndexWriter();
+
+    /**
+     * @brief ʱļ
+     * @param path ļ·
+     * @param src Դļԣдļͷ
+     */
+    bool open(const std::string& path, const IndexSource& src);
+
+    /**
+     * @brief һ֡׷ӵڹ߳еã
+     * @param out 
+     * @param f ֡
+     * @param offset ֡еƫ
+     */
+    static void appendEntry(TextBuffer& out, const FrameInfo& f, uint64_t offset);
+
+    /**
+     * @brief ˳뻺едȻջ
+     */
+    void write(TextBuffer& entries);
+
+    /**
+     * @brief дļͷ滻ʽļ
+     * @return дʧܷ false
+     */
+    bool finish();
+
+    uint64_t count() const {
+        return frames;
+    }
+
+private:
+    /**
+     * @brief 㣺ĳ֡ʼƫƼ¼ļеλ
+     */
+    struct Checkpoint {
+        uint64_t offset;
+        uint64_t position;
+    };
+
+    FILE* fp = nullptr;
+    std::string finalPath;
+    std::string tempPath;
+    IndexSource source;
+    TextBuffer stream{ 64 * 1024 };
+    std::vector<Checkpoint> checkpoints;
+    uint64_t frames = 0;
+    uint64_t position = INDEX_HEADER_SIZE; // һ¼ļеλ
+    uint64_t prevEnd = 0;                  // һ֡ĩβƫ
+    uint32_t prevSec = 0;                  // һ֡ʱ
+    bool failed = false;
+};
+
+/**
+ * @brief ѽͨڳʱڶλһ֡
+ */
+class FrameIndex {
+public:
+    /**
+     * @brief 򿪲Уļ
+     * @return ļڻʽ󷵻 false
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief ǷԴļǰĴС޸ʱ估У㷨һ
+     */
+    bool matches(const IndexSource& src) const;
+
+    uint64_t count() const {
+        return frames;
+    }
+
+    CaptureFormat format() const {
+        return captureFormat;
+    }
+
+    /**
+     * @brief ҵ number ֡1ʼ
+     * @return Χ false
+     */
+    bool lookup(uint64_t number, IndexEntry& e) const;
+
+private:
+    std::unique_ptr<InputSource> file;
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    uint16_t interval = INDEX_CHECKPOINT_INTERVAL;
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    uint64_t frames = 0;
+    uint64_t checkpointPos = 0;
+    FcsType fcs = FcsType::Crc8;
+    CaptureFormat captureFormat = CaptureFormat::Raw;
+};
+
+/**
+ * @brief ļָλöȡһ
+ * @param fp Ѵ򿪵ļ
+ * @param offset ʼƫ
+ * @param len 
+ * @param buf 
+ * @return ȡ false
+ */
+bool readAt(FILE* fp, uint64_t offset, size_t len, std::vector<unsigned char>& buf);
@@ -0,0 +1,399 @@
+#include "FrameReport.h"
+#include "FrameIndex.h"
+#include "FrameFilter.h"
+#include "../Common/OuiTable.h"
+#include "../Common/ProtocolViews.h"
+
+#include <cstring>
+
+using namespace std;
+
+bool parseOutputFormat(const char* name, OutputFormat& fmt) {
+    if (strcmp(name, "text") == 0) fmt = OutputFormat::Text;
+    else if (strcmp(name, "jsonl") == 0) fmt = OutputFormat::Jsonl;
+    else if (strcmp(name, "csv") == 0) fmt = OutputFormat::Csv;
+    else if (strcmp(name, "bin") == 0) fmt = OutputFormat::Bin;
+    else return false;
+    return true;
+}
+
+namespace {
+
+/**
+ * @brief  MAC ַѵǼǵ OUI 󸽳
+ */
+TextBuffer& macWithVendor(TextBuffer& out, const uint8_t* addr) {
+    out.mac(addr);
+    if (const char* vendor = macVendor(addr)) {
+        out.put(" (").put(vendor).put(')');
+    }
+    return out;
+}
+
+/**
+ * @brief JSON еĳֶΣδǼǵ OUI 
+ */
+void jsonVendor(TextBuffer& out, const char* key, const uint8_t* addr) {
+    if (const char* vendor = macVendor(addr)) {
+        out.put(",\"").put(key).put("\":\"");
+        for (const char* p = vendor; *p; ++p) {
+            if (*p == '"' || *p == '\\') out.put('\\');
+            out.put(*p);
+        }
+        out.put('"');
+    }
+}
+
+/**
+ * @brief ʶֶеϲЭ
+ */
+inline void frameLayers(const FrameInfo& f, PacketLayers& layers) {
+    decodeLayers((uint16_t)f.etherType, f.payload, f.payloadLen, layers);
+}
+
+/**
+ * @brief Эżƣ "TCP (6)"
+ */
+void protocolField(TextBuffer& out, uint8_t proto) {
+    const char* name = ipProtocolName(proto);
+    if (name) out.put(name).put(" (").dec(proto).put(')');
+    else out.dec(proto);
+}
+
+/**
+ * @brief  TCP ־ƣԿոָ
+ */
+void tcpFlags(TextBuffer& out, uint16_t flags) {
+    static const char* const NAMES[] = { "FIN", "SYN", "RST", "PSH", "ACK", "URG", "ECE", "CWR", "NS" };
+    bool first = true;
+    for (int i = 8; i >= 0; --i) {
+        if (flags & (1u << i)) {
+            if (!first) out.put(' ');
+            out.put(NAMES[i]);
+            first = false;
+        }
+    }
+    if (first) out.put('-');
+}
+
+/**
+ * @brief ıеϲЭ鲿֣ÿһ
+ */
+void printLayers(TextBuffer& out, const PacketLayers& l) {
+    for (int i = 0; i < l.vlanCount; ++i) {
+        out.put("VLAN:       ID ").dec(l.vlans[i].vlanId()).put(", ȼ ").dec(l.vlans[i].priority())
+           .put(", ڲ 0x").hex(l.vlans[i].etherType(), 4).put('\n');
+    }
+    if (l.arp.valid()) {
+        const ArpView& a = l.arp;
+        out.put("ARP:        ");
+        if (!a.isEthernetIpv4()) {
+            out.put(" ").dec(a.opcode()).put(", Ӳ ").dec(a.hardwareType())
+               .put(", Э 0x").hex(a.protocolType(), 4).put('\n');
+        }
+        else if (a.opcode() == ArpView::OP_REQUEST) {
+            out.put(" ").ipv4(a.targetProtocol()).put(" ĵַ, ͷ ")
+               .ipv4(a.senderProtocol()).put(" (").mac(a.senderHardware()).put(")\n");
+        }
+        else {
+            out.put(a.opcode() == ArpView::OP_REPLY ? "Ӧ " : " ");
+            if (a.opcode() != ArpView::OP_REPLY) out.dec(a.opcode()).put(' ');
+            out.ipv4(a.senderProtocol()).put(" λ ").mac(a.senderHardware())
+               .put(", Ŀ ").ipv4(a.targetProtocol()).put(" (").mac(a.targetHardware()).put(")\n");
+        }
+    }
+    if (l.ipv4.valid()) {
+        const Ipv4View& ip = l.ipv4;
+        out.put("IPv4:       ").ipv4(ip.src()).put(" -> ").ipv4(ip.dst()).put(", Э ");
+        protocolField(out, ip.protocol());
+        out.put(", TTL ").dec(ip.ttl()).put(", ܳ ").dec(ip.totalLength());
+        if (ip.moreFragments() || ip.laterFragment()) {
+            out.put(", Ƭƫ ").dec((uint64_t)ip.fragmentOffset() * 8);
+        }
+        out.put('\n');
+    }
+    if (l.ipv6.valid()) {
+        const Ipv6View& ip = l.ipv6;
+        out.put("IPv6:       ").ipv6(ip.src()).put(" -> ").ipv6(ip.dst()).put(", ϲЭ ");
+        protocolField(out, l.ipProto);
+        out.put(",  ").dec(ip.hopLimit()).put(", غɳ ").dec(ip.payloadLength()).put('\n');
+    }
+    if (l.tcp.valid()) {
+        out.put("TCP:        ˿ ").dec(l.tcp.srcPort()).put(" -> ").dec(l.tcp.dstPort()).put(", ־ ");
+        tcpFlags(out, l.tcp.flags());
+        out.put(",  ").dec(l.tcp.seq()).put(", ȷϺ ").dec(l.tcp.ack()).put(",  ").dec(l.tcp.window()).put('\n');
+    }
+    if (l.udp.valid()) {
+        out.put("UDP:        ˿ ").dec(l.udp.srcPort()).put(" -> ").dec(l.udp.dstPort())
+           .put(",  ").dec(l.udp.length()).put('\n');
+    }
+    if (l.icmp.valid()) {
+        out.put(l.ipProto == IP_PROTO_ICMPV6 ? "ICMPv6:      " : "ICMP:        ").dec(l.icmp.type())
+           .put(",  ").dec(l.icmp.code()).put('\n');
+    }
+}
+
+/**
+ * @brief JSON еϲЭֶΣֻʶĲ
+ */
+void jsonLayers(TextBuffer& out, const PacketLayers& l) {
+    if (l.vlanCount > 0) {
+        out.put(",\"vlan\":[");
+        for (int i = 0; i < l.vlanCount; ++i) {
+            if (i) out.put(',');
+            out.dec(l.vlans[i].vlanId());
+        }
+        out.put(']');
+    }
+    if (l.arp.valid() && l.arp.isEthernetIpv4()) {
+        out.put(",\"arp_op\":").dec(l.arp.opcode());
+        out.put(",\"arp_sha\":\"").mac(l.arp.senderHardware()).put('"');
+        out.put(",\"arp_spa\":\"").ipv4(l.arp.senderProtocol()).put('"');
+        out.put(",\"arp_tha\":\"").mac(l.arp.targetHardware()).put('"');
+        out.put(",\"arp_tpa\":\"").ipv4(l.arp.targetProtocol()).put('"');
+    }
+    if (l.ipv4.valid()) {
+        out.put(",\"ip_src\":\"").ipv4(l.ipv4.src()).put('"');
+        out.put(",\"ip_dst\":\"").ipv4(l.ipv4.dst()).put('"');
+        out.put(",\"ip_proto\":").dec(l.ipProto);
+        out.put(",\"ttl\":").dec(l.ipv4.ttl());
+    }
+    if (l.ipv6.valid()) {
+        out.put(",\"ip_src\":\"").ipv6(l.ipv6.src()).put('"');
+        out.put(",\"ip_dst\":\"").ipv6(l.ipv6.dst()).put('"');
+        out.put(",\"ip_proto\":").dec(l.ipProto);
+        out.put(",\"ttl\":").dec(l.ipv6.hopLimit());
+    }
+    if (l.tcp.valid()) {
+        out.put(",\"sport\":").dec(l.tcp.srcPort()).put(",\"dport\":").dec(l.tcp.dstPort());
+        out.put(",\"tcp_flags\":").dec(l.tcp.flags());
+    }
+    if (l.udp.valid()) {
+        out.put(",\"sport\":").dec(l.udp.srcPort()).put(",\"dport\":").dec(l.udp.dstPort());
+    }
+    if (l.icmp.valid()) {
+        out.put(",\"icmp_type\":").dec(l.icmp.type()).put(",\"icmp_code\":").dec(l.icmp.code());
+    }
+}
+
+/**
+ * @brief CSV ĩβϲЭУvlan,ip_src,ip_dst,ip_proto,sport,dportûжӦʱգ
+ */
+void csvLayers(TextBuffer& out, const PacketLayers& l) {
+    out.put(',');
+    if (l.vlanCount > 0) out.dec(l.vlans[l.vlanCount - 1].vlanId());
+    out.put(',');
+    if (l.ipv4.valid()) out.ipv4(l.ipv4.src()).put(',').ipv4(l.ipv4.dst()).put(',').dec(l.ipProto);
+    else if (l.ipv6.valid()) out.ipv6(l.ipv6.src()).put(',').ipv6(l.ipv6.dst()).put(',').dec(l.ipProto);
+    else if (l.arp.valid() && l.arp.isEthernetIpv4()) out.ipv4(l.arp.senderProtocol()).put(',').ipv4(l.arp.targetProtocol()).put(',');
+    else out.put(",,");
+    out.put(',');
+    if (l.tcp.valid()) out.dec(l.tcp.srcPort()).put(',').dec(l.tcp.dstPort());
+    else if (l.udp.valid()) out.dec(l.udp.srcPort()).put(',').dec(l.udp.dstPort());
+    else out.put(',');
+}
+
+/**
+ * @brief ÿ֡һ JSONֶ FCS ʮֵ
+ */
+void jsonFrame(TextBuffer& out, const FrameInfo& f, int number, uint64_t offset) {
+    out.put("{\"index\":").dec((uint64_t)number);
+    out.put(",\"offset\":").dec(offset);
+    out.put(",\"dst\":\"").mac(f.header).put('"');
+    out.put(",\"src\":\"").mac(f.header + 6).put('"');
+    jsonVendor(out, "dst_vendor", f.header);
+    jsonVendor(out, "src_vendor", f.header + 6);
+    out.put(",\"ethertype\":").dec(f.etherType);
+    out.put(",\"payload_len\":").dec(f.payloadLen);
+    out.put(",\"fcs\":").dec(f.fcs);
+    out.put(",\"calc\":").dec(f.calc);
+    PacketLayers layers;
+    frameLayers(f, layers);
+    jsonLayers(out, layers);
+    out.put(",\"status\":\"").put(f.accepted() ? "Accept" : "Reject").put("\"}\n");
+}
+
+/**
+ * @brief CSV һУֶ FCS ʮıһ
+ */
+void csvFrame(TextBuffer& out, const FrameInfo& f, int number, uint64_t offset, int fcsWidth) {
+    out.dec((uint64_t)number).put(',');
+    out.dec(offset).put(',');
+    out.mac(f.header).put(',');
+    out.mac(f.header + 6).put(',');
+    out.put("0x").hex(f.etherType, 4).put(',');
+    out.dec(f.payloadLen).put(',');
+    if (fcsWidth > 0) {
+        out.put("0x").hex(f.fcs, fcsWidth).put(',');
+        out.put("0x").hex(f.calc, fcsWidth).put(',');
+    }
+    else {
+        out.put(",,"); // ֡в FCS
+    }
+    out.put(f.accepted() ? "Accept" : "Reject");
+    PacketLayers layers;
+    frameLayers(f, layers);
+    csvLayers(out, layers);
+    out.put('\n');
+}
+
+/**
+ * @brief һ bin ¼ֶΰСдֽ޹
+ */
+void binFrame(TextBuffer& out, const FrameInfo& f, int number, uint64_t offset, FcsType fcsType) {
+    uint8_t flags = 0;
+    if (f.accepted()) flags |= FRAME_FLAG_ACCEPTED;
+    if (f.fcs == f.calc) flags |= FRAME_FLAG_FCS_OK;
+    if (f.lengthOk) flags |= FRAME_FLAG_LENGTH_OK;
+
+    out.le((uint32_t)number, 4);
+    out.le((uint32_t)f.payloadLen, 4);
+    out.le(offset, 8);
+    out.put((const char*)f.header, 12);
+    out.le(f.etherType, 2);
+    out.put((char)flags);
+    out.put((char)fcsLength(fcsType));
+    out.le(f.fcs, 4);
+    out.le(f.calc, 4);
+}
+
+} // namespace
+
+void writeReportHeader(TextBuffer& out, OutputFormat fmt, FcsType fcsType) {
+    if (fmt == OutputFormat::Csv) {
+        out.put("index,offset,dst,src,ethertype,payload_len,fcs,calc,status,vlan,ip_src,ip_dst,ip_proto,sport,dport\n");
+    }
+    else if (fmt == OutputFormat::Bin) {
+        out.put(FRAME_RECORD_MAGIC, sizeof(FRAME_RECORD_MAGIC));
+        out.le(FRAME_RECORD_VERSION, 2);
+        out.le(sizeof(FrameRecord), 2);
+        out.put((char)fcsLength(fcsType));
+        out.fill('\0', FRAME_RECORD_HEADER_SIZE - 9);
+    }
+}
+
+void writeFrame(TextBuffer& out, OutputFormat fmt, const FrameInfo& f, int number, uint64_t offset, FcsType fcsType) {
+    switch (fmt) {
+    case OutputFormat::Jsonl:
+        jsonFrame(out, f, number, offset);
+        break;
+    case OutputFormat::Csv:
+        csvFrame(out, f, number, offset, (int)fcsLength(fcsType) * 2);
+        break;
+    case OutputFormat::Bin:
+        binFrame(out, f, number, offset, fcsType);
+        break;
+    default:
+        printFrame(out, f, number, fcsType);
+        break;
+    }
+}
+
+void FrameReporter::begin(ReportBuffers& out) const {
+    if (opt.frames) {
+        writeReportHeader(out.text, opt.format, opt.fcs);
+    }
+}
+
+bool FrameReporter::fcsOnDecode() const {
+    return !opt.filter || opt.filter->usesFcs();
+}
+
+void FrameReporter::frame(ReportBuffers& out, FrameInfo& f, int number, uint64_t offset) const {
+    if (opt.filter) {
+        if (!opt.filter->matches(f, number, offset)) {
+            return;
+        }
+        if (!opt.filter->usesFcs()) {
+            checkFrameFcs(f, opt.fcs);
+        }
+    }
+    if (opt.frames) {
+        writeFrame(out.text, opt.format, f, number, offset, opt.fcs);
+    }
+    if (opt.stats) {
+        if (!out.stats) out.stats.reset(new FrameStats());
+        out.stats->add(f);
+    }
+    if (opt.accepted && f.accepted()) {
+        CaptureWriter::appendRecord(out.accepted, f);
+    }
+    else if (opt.rejected && !f.accepted()) {
+        CaptureWriter::appendRecord(out.rejected, f);
+    }
+    if (opt.index) {
+        FrameIndexWriter::appendEntry(out.index, f, offset);
+    }
+}
+
+void FrameReporter::write(ReportBuffers& out) const {
+    out.text.flush();
+    if (opt.accepted) opt.accepted->write(out.accepted);
+    if (opt.rejected) opt.rejected->write(out.rejected);
+    if (opt.index) opt.index->write(out.index);
+}
+
+void FrameReporter::collect(ReportBuffers& out) {
+    if (!out.stats) {
+        return;
+    }
+    if (!total) {
+        total = move(out.stats);
+    }
+    else {
+        total->merge(*out.stats);
+        out.stats.reset();
+    }
+}
+
+void printFrame(TextBuffer& out, const FrameInfo& f, int number, FcsType fcsType) {
+    const int fcsWidth = (int)fcsLength(fcsType) * 2;
+    const char* rule = "------------------------------------------\n";
+
+    out.put(": ").dec((uint64_t)number, 2, '0').put('\n');
+    out.put(rule);
+    if (f.hasPreamble()) {
+        out.put("ǰ:     ");
+        for (int i = 0; i < 7; ++i) {
+            out.hex8(f.frame[i]).put(' ');
+        }
+        out.put('\n');
+        out.put("֡ǰ: ").hex8(f.frame[7]).put('\n');
+    }
+    else {
+        // ץļе֡ǰ룬ʾץʱ
+        out.put("ʱ:     ").dec(f.tsSec).put('.').dec(f.tsUsec, 6, '0').put('\n');
+    }
+
+    out.put("Ŀĵַ:   ");
+    macWithVendor(out, f.header).put('\n');
+    out.put("Դַ:     ");
+    macWithVendor(out, f.header + 6).put('\n');
+    out.put("ֶ:   0x").hex(f.etherType, 4).put('\n');
+
+    out.put("ֶγ: ").dec(f.payloadLen).put(" ֽ\n");
+    if (!f.lengthOk) {
+        if (f.payloadLen < ETH_MIN_PAYLOAD) {
+            out.put("쳣: ֶγȹ̣С ").dec(ETH_MIN_PAYLOAD).put(" ֽڣΪض֡֡\n");
+        } else {
+            out.put("쳣: ֶγȹ ").dec(ETH_MAX_PAYLOAD).put(" ֽڣܰݻ\n");
+        }
+    }
+
+    PacketLayers layers;
+    frameLayers(f, layers);
+    printLayers(out, layers);
+
+    out.put("ֶ(ASCII): ").ascii(f.payload, f.payloadLen).put('\n');
+    if (fcsWidth > 0) {
+        out.put("CRCУ(ļ): 0x").hex(f.fcs, fcsWidth).put('\n');
+        out.put("CRCУ(): 0x").hex(f.calc, fcsWidth).put('\n');
+    }
+    else {
+        out.put("CRCУ:    ޣ֡в FCS\n");
+    }
+
+    // ״̬ҽCRCƥҳʱ
+    out.put("״̬:       ").put(f.accepted() ? "Accept" : "Reject").put('\n');
+    out.put(rule).put('\n');
+}
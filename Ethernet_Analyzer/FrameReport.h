@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "FrameDecoder.h"
+#include "CaptureFile.h"
+#include "FrameStats.h"
+
+class FrameIndexWriter;
+class FrameFilter;
+#include "../Common/TextBuffer.h"
+
+// ------------------  ------------------
+
+/**
+ * @brief ʽ
+ */
+enum class OutputFormat {
+    Text,  // ıע֡棨Ĭϣ
+    Jsonl, // ÿ֡һ JSON 
+    Csv,   // ͷ CSVÿ֡һ
+    Bin    // С˶Ƽ¼ FrameRecord
+};
+
+/**
+ * @brief ƽʽ
+ * @param name text / jsonl / csv / bin
+ * @param fmt 
+ * @return Чʱ false
+ */
+bool parseOutputFormat(const char* name, OutputFormat& fmt);
+
+// bin ʽ16ֽļͷ֮ 40 ֽڼ¼ΪС
+//   ļͷ: magic "EAFR" | uint16 汾(1) | uint16 ¼(40) | uint8 FCS ֽ | 7ֽڱ(0)
+//   ¼:    FrameRecord8ֽڶ룬ֱӳļ±
+const char FRAME_RECORD_MAGIC[4] = { 'E', 'A', 'F', 'R' };
+const uint16_t FRAME_RECORD_VERSION = 1;
+const size_t FRAME_RECORD_HEADER_SIZE = 16;
+
+// FrameRecord::flags λĺ
+const uint8_t FRAME_FLAG_ACCEPTED = 0x01; // ֡
+const uint8_t FRAME_FLAG_FCS_OK = 0x02;   // ļе FCS ֵһ
+const uint8_t FRAME_FLAG_LENGTH_OK = 0x04; // ֶγ
+
+/**
+ * @brief bin ʽһ¼СļеĲһ£
+ */
+struct FrameRecord {
+    uint32_t index;       // ֡ţ1ʼ
+    uint32_t payloadLen;  // ֶγ
+    uint64_t offset;      // ֡ǰ룩еƫ
+    uint8_t dst[6];       // Ŀĵַ
+    uint8_t src[6];       // Դַ
+    uint16_t etherType;   // ֶ
+    uint8_t flags;        // FRAME_FLAG_* 
+    uint8_t fcsLen;       // FCS ֽ1  4
+    uint32_t fcs;         // ļе FCS
+    uint32_t calc;        // õ FCS
+};
+static_assert(sizeof(FrameRecord) == 40, "FrameRecord ֱļʽһ");
+
+/**
+ * @brief ʽĿͷ֣CSV ͷ bin ļͷtext  jsonl 
+ * @param out 
+ * @param fmt ʽ
+ * @param fcsType ֡βУ㷨
+ */
+void writeReportHeader(TextBuffer& out, OutputFormat fmt, FcsType fcsType);
+
+/**
+ * @brief ָʽһ֡Ľ
+ * @param out 
+ * @param fmt ʽ
+ * @param f ֡
+ * @param number ֡ţ1ʼ
+ * @param offset ֡еƫ
+ * @param fcsType ֡βУ㷨
+ */
+void writeFrame(TextBuffer& out, OutputFormat fmt, const FrameInfo& f, int number, uint64_t offset, FcsType fcsType);
+
+/**
+ * @brief һ֡ȫıԼҪд֡ / ܾ֡ץļļ¼
+ */
+struct ReportBuffers {
+    TextBuffer text;
+    TextBuffer accepted;
+    TextBuffer rejected;
+    TextBuffer index;                  // ʱÿ֡ IndexEntryдʱ˳
+    std::unique_ptr<FrameStats> stats; // ͳģʽ±ۼӵļ״ʹʱ
+
+    ReportBuffers() : accepted(4096), rejected(4096), index(4096) {
+    }
+
+    /**
+     * @brief ۻǷѴﵽһдĴС
+     */
+    bool full() const {
+        return text.size() + accepted.size() + rejected.size() + index.size() >= TextBuffer::FLUSH_SIZE;
+    }
+};
+
+/**
+ * @brief ѡ
+ */
+struct ReportOptions {
+    OutputFormat format = OutputFormat::Text; // ֡ĸʽ
+    FcsType fcs = FcsType::Crc8;              // ֡βУ㷨
+    bool frames = true;                       // Ƿ֡
+    bool stats = false;                       // Ƿۼͳ
+    CaptureWriter* accepted = nullptr;        // ֡ļ
+    CaptureWriter* rejected = nullptr;        // ܾ֡ļ
+    FrameIndexWriter* index = nullptr;        // ڽ֡
+    const FrameFilter* filter = nullptr;      // ֻ˱ʽ֡
+};
+
+/**
+ * @brief 水ѡʽд׼ / ܾ֡ɷֱΪ pcap
+ *        ͬʱ֡
+ *
+ * frame() ֻ÷Ļ׷ݣڶ߳ͬʱã
+ * write() ѻ֡˳дͬһʱֻһ̵߳á
+ * ͳƼۼڸУʱ collect() ϲ
+ * ˹˱ʽʱ֡ԣͳơ棩֡űֲ䡣
+ */
+class FrameReporter {
+public:
+    explicit FrameReporter(const ReportOptions& options) : opt(options) {
+    }
+
+    /**
+     * @brief ʽĿͷ֣CSV ͷbin ļͷ
+     */
+    void begin(ReportBuffers& out) const;
+
+    /**
+     * @brief ֡ʱǷҪУ
+     *
+     * ˱ʽУʱ falseʱУ飬ֻΪͨ˵֡㡣
+     */
+    bool fcsOnDecode() const;
+
+    /**
+     * @brief һ֡
+     * @param out 
+     * @param f ֡ fcsOnDecode() У飬ͨ˺ڴ˲
+     * @param number ֡ţ1ʼ
+     * @param offset ֡еƫ
+     */
+    void frame(ReportBuffers& out, FrameInfo& f, int number, uint64_t offset) const;
+
+    /**
+     * @brief дջ
+     */
+    void write(ReportBuffers& out) const;
+
+    /**
+     * @brief ѻۼӵͳƺϲܼƣд
+     */
+    void collect(ReportBuffers& out);
+
+    /**
+     * @brief ͳƵܼƣδͳʱΪ nullptr
+     */
+    const FrameStats* stats() const {
+        return total.get();
+    }
+
+private:
+    ReportOptions opt;
+    std::unique_ptr<FrameStats> total;
+};
+
+/**
+ * @brief ıʽһ֡Ľ
+ * @param out 
+ * @param f ֡
+ * @param number ֡ţ1ʼ
+ * @param fcsType ֡βУ㷨 FCS ʾ
+ */
+void printFrame(TextBuffer& out, const FrameInfo& f, int number, FcsType fcsType);
@@ -0,0 +1,163 @@
+#include "FrameScanner.h"
+#include "CpuFeatures.h"
+
+#include <cstring>
+
+#ifdef ANALYZER_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+inline unsigned int lowestBit(unsigned int mask) {
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return (unsigned int)idx;
+#else
+    return (unsigned int)__builtin_ctz(mask);
+#endif
+}
+
+/**
+ * @brief ͨʵ֣Ե8ֽΪ̽룬̽Ȳ 0xAA Ҳ 0xAB ʱֱ8ֽ
+ */
+void scanPortable(const unsigned char* data, size_t size, size_t from, vector<size_t>& out) {
+    size_t p = from;
+    while (p + 8 <= size) {
+        unsigned char probe = data[p + 7];
+        if (probe == 0xAB) {
+            if (isPreamble(data + p)) {
+                out.push_back(p);
+                p += 8; // ǰ8ֽ
+                continue;
+            }
+            ++p;
+        }
+        else if (probe == 0xAA) {
+            ++p;
+        }
+        else {
+            p += 8; // [p, p+7] еκλöǰĿͷ
+        }
+    }
+}
+
+#ifdef ANALYZER_X86
+
+#if defined(__GNUC__) && !defined(__SSE2__)
+__attribute__((target("sse2")))
+#endif
+void scanSse2(const unsigned char* data, size_t size, size_t from, vector<size_t>& out) {
+    const __m128i aa = _mm_set1_epi8((char)0xAA);
+    const __m128i ab = _mm_set1_epi8((char)0xAB);
+    size_t p = from;
+    // ÿж16ʼλãͷֽΪ 0xAA ҵ8ֽΪ 0xAB λòһȷ
+    while (p + 7 + 16 <= size) {
+        __m128i head = _mm_loadu_si128((const __m128i*)(data + p));
+        __m128i sfd = _mm_loadu_si128((const __m128i*)(data + p + 7));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(head, aa), _mm_cmpeq_epi8(sfd, ab)));
+        while (mask) {
+            size_t c = p + lowestBit(mask);
+            if (isPreamble(data + c)) {
+                out.push_back(c);
+            }
+            mask &= mask - 1;
+        }
+        p += 16;
+    }
+    scanPortable(data, size, p, out);
+}
+
+#if defined(__GNUC__)
+__attribute__((target("avx2")))
+#endif
+void scanAvx2(const unsigned char* data, size_t size, size_t from, vector<size_t>& out) {
+    const __m256i aa = _mm256_set1_epi8((char)0xAA);
+    const __m256i ab = _mm256_set1_epi8((char)0xAB);
+    size_t p = from;
+    // ÿж32ʼλ
+    while (p + 7 + 32 <= size) {
+        __m256i head = _mm256_loadu_si256((const __m256i*)(data + p));
+        __m256i sfd = _mm256_loadu_si256((const __m256i*)(data + p + 7));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(head, aa), _mm256_cmpeq_epi8(sfd, ab)));
+        while (mask) {
+            size_t c = p + lowestBit(mask);
+            if (isPreamble(data + c)) {
+                out.push_back(c);
+            }
+            mask &= mask - 1;
+        }
+        p += 32;
+    }
+    scanPortable(data, size, p, out);
+}
+
+#endif // ANALYZER_X86
+
+typedef void (*ScanKernel)(const unsigned char*, size_t, size_t, vector<size_t>&);
+
+struct KernelChoice {
+    ScanKernel fn;
+    const char* name;
+};
+
+KernelChoice chooseKernel() {
+#ifdef ANALYZER_X86
+    const CpuFeatures& cpu = cpuFeatures();
+    if (cpu.avx2) return KernelChoice{ scanAvx2, "AVX2" };
+    if (cpu.sse2) return KernelChoice{ scanSse2, "SSE2" };
+#endif
+    return KernelChoice{ scanPortable, "portable" };
+}
+
+const KernelChoice& kernel() {
+    static const KernelChoice choice = chooseKernel();
+    return choice;
+}
+
+} // namespace
+
+void findPreambles(const unsigned char* data, size_t size, size_t from, vector<size_t>& out) {
+    if (from >= size) return;
+    kernel().fn(data, size, from, out);
+}
+
+size_t marksToSpans(const vector<size_t>& marks, size_t size, size_t from, bool atEnd, vector<FrameSpan>& spans) {
+    if (marks.empty()) {
+        if (atEnd) return size;
+        // ĩβ8ֽڵĲֿһǰĿͷ
+        return (size - from > 7) ? size - 7 : from;
+    }
+
+    size_t start = marks[0];
+    for (size_t i = 1; i < marks.size(); ++i) {
+        if (marks[i] < start + 9) {
+            continue; // ǰ֮ǰڵǰ֡
+        }
+        spans.push_back(FrameSpan{ start, marks[i] });
+        start = marks[i];
+    }
+
+    if (atEnd) {
+        spans.push_back(FrameSpan{ start, size });
+        return size;
+    }
+    return start; // һ֡ĽλҪȺݲȷ
+}
+
+size_t splitFrames(const unsigned char* data, size_t size, size_t from, bool atEnd, vector<FrameSpan>& spans) {
+    // ÿ̸߳ͬһλñÿ·
+    thread_local vector<size_t> marks;
+    marks.clear();
+    findPreambles(data, size, from, marks);
+    return marksToSpans(marks, size, from, atEnd, spans);
+}
+
+const char* preambleKernelName() {
+    return kernel().name;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// ------------------ ߽֡ ------------------
+
+// ÿɨֽɨʹ֡ռõڴ治ļС
+const size_t SCAN_BATCH = 1024 * 1024;
+
+// ǰ룺7ֽ 0xAA + ֡ǰ 0xAB
+const unsigned char PREAMBLE[8] = { 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAB };
+
+/**
+ * @brief p ʼ8ֽǷΪǰ
+ */
+inline bool isPreamble(const unsigned char* p) {
+    return memcmp(p, PREAMBLE, sizeof(PREAMBLE)) == 0;
+}
+
+/**
+ * @brief һѡ֡ڴеķΧ
+ */
+struct FrameSpan {
+    size_t start; // ǰһֽڵ±ꣻץļΪ֡ͷĿĵַ±
+    size_t end;   // һǰ±ꣻһ֡ΪĩβץļΪ¼ݵĩβ
+    uint32_t tsSec = 0;  // ץʱ룩ԭʼ֡ļΪ0
+    uint32_t tsUsec = 0; // ץʱ΢벿
+};
+
+/**
+ * @brief  data[from, size) ǰ (7 x 0xAA + 0xAB)
+ * @param data ָ
+ * @param size ݳ
+ * @param from ʼҵ±
+ * @param out ׷ÿǰһֽڵ±
+ */
+void findPreambles(const unsigned char* data, size_t size, size_t from, std::vector<size_t>& out);
+
+/**
+ * @brief ǰλðݻΪ֡
+ *
+ * ֡ҵĹһ£һ֡ǰλڵǰǰ֮ 9 ֽڴ
+ * ڵǰǰ֮ǰΪǰ֡ݡ
+ * @param marks findPreambles õ data[from, size) еǰλ
+ * @param size ݳ
+ * @param from ʼֵ±
+ * @param atEnd data[size] ֮ǷûݣΪ false ʱһǰڵ֡δ
+ * @param spans ׷ӱ߽ȷ֡
+ * @return ´μֵʼ±
+ */
+size_t marksToSpans(const std::vector<size_t>& marks, size_t size, size_t from, bool atEnd, std::vector<FrameSpan>& spans);
+
+/**
+ * @brief ɨһ data[from, size)ǰݻΪ֡findPreambles + marksToSpans
+ * @param data ָ
+ * @param size ݳ
+ * @param from ʼֵ±
+ * @param atEnd data[size] ֮ǷûݣΪ false ʱһǰڵ֡δ
+ * @param spans ׷ӱ߽ȷ֡
+ * @return ´μֵʼ±
+ */
+size_t splitFrames(const unsigned char* data, size_t size, size_t from, bool atEnd, std::vector<FrameSpan>& spans);
+
+/**
+ * @brief ǰʹõǰʵ ("AVX2""SSE2"  "portable")
+ */
+const char* preambleKernelName();
@@ -0,0 +1,253 @@
+#include "FrameStats.h"
+#include "../Common/OuiTable.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+// ֶγȷֲķ飺[, ]
+struct LengthBucket {
+    size_t lo;
+    size_t hi;
+};
+
+const LengthBucket LENGTH_BUCKETS[] = {
+    { 0, ETH_MIN_PAYLOAD - 1 },
+    { ETH_MIN_PAYLOAD, 63 },
+    { 64, 127 },
+    { 128, 255 },
+    { 256, 511 },
+    { 512, 1023 },
+    { 1024, ETH_MAX_PAYLOAD },
+    { ETH_MAX_PAYLOAD + 1, ~(size_t)0 },
+};
+
+const size_t TOP_MACS = 10;
+const size_t ETH_TYPE_MIN = 0x0600; // ֶεСֵСֵʾ 802.3 
+
+/**
+ * @brief ֶε
+ */
+const char* etherTypeName(unsigned int type) {
+    switch (type) {
+    case 0x0800: return "IPv4";
+    case 0x0806: return "ARP";
+    case 0x8035: return "RARP";
+    case 0x8100: return "VLAN";
+    case 0x86DD: return "IPv6";
+    case 0x8847: return "MPLS";
+    case 0x8863: return "PPPoE-D";
+    case 0x8864: return "PPPoE-S";
+    case 0x888E: return "EAPOL";
+    case 0x88A8: return "QinQ";
+    case 0x88CC: return "LLDP";
+    default:     return "";
+    }
+}
+
+inline uint64_t packMac(const uint8_t* a) {
+    return ((uint64_t)a[0] << 40) | ((uint64_t)a[1] << 32) | ((uint64_t)a[2] << 24) |
+           ((uint64_t)a[3] << 16) | ((uint64_t)a[4] << 8) | (uint64_t)a[5];
+}
+
+inline size_t hashMac(uint64_t mac) {
+    mac *= 0x9E3779B97F4A7C15ull; // ˷ɢУλϽϺ
+    return (size_t)(mac >> 32);
+}
+
+/**
+ * @brief  part / total İٷֱȣһλС
+ */
+void percent(TextBuffer& out, uint64_t part, uint64_t total) {
+    uint64_t permille = total ? (part * 1000 + total / 2) / total : 0;
+    out.dec(permille / 10, 3, ' ').put('.').dec(permille % 10).put('%');
+}
+
+/**
+ * @brief һλСֵ
+ */
+void fixed1(TextBuffer& out, double v) {
+    uint64_t tenths = (uint64_t)(v * 10 + 0.5);
+    out.dec(tenths / 10).put('.').dec(tenths % 10);
+}
+
+void printTop(TextBuffer& out, const char* title, const MacCounter& macs, uint64_t frames) {
+    out.put(title).put(" ( ").dec(macs.size()).put(" ַ):\n");
+    for (const MacCounter::Entry& e : macs.top(TOP_MACS)) {
+        uint8_t addr[6];
+        for (int i = 0; i < 6; ++i) {
+            addr[i] = (uint8_t)(e.mac >> (40 - 8 * i));
+        }
+        out.put("  ").mac(addr).put("  ").dec(e.count, 12, ' ').put("  ");
+        percent(out, e.count, frames);
+        if (const char* vendor = macVendor(addr)) {
+            out.put("  ").put(vendor);
+        }
+        out.put('\n');
+    }
+}
+
+} // namespace
+
+// ------------------ MacCounter ------------------
+
+MacCounter::MacCounter() : slots(1024, Entry{ EMPTY, 0 }) {
+}
+
+void MacCounter::add(const uint8_t* addr, uint64_t n) {
+    insert(packMac(addr), n);
+}
+
+void MacCounter::insert(uint64_t mac, uint64_t n) {
+    const size_t mask = slots.size() - 1;
+    for (size_t i = hashMac(mac) & mask;; i = (i + 1) & mask) {
+        Entry& e = slots[i];
+        if (e.mac == mac) {
+            e.count += n;
+            return;
+        }
+        if (e.mac == EMPTY) {
+            e.mac = mac;
+            e.count = n;
+            // װʳһʱݣ̽ж
+            if (++used * 2 > slots.size()) {
+                grow();
+            }
+            return;
+        }
+    }
+}
+
+void MacCounter::grow() {
+    vector<Entry> old(slots.size() * 2, Entry{ EMPTY, 0 });
+    old.swap(slots);
+    used = 0;
+    for (const Entry& e : old) {
+        if (e.mac != EMPTY) insert(e.mac, e.count);
+    }
+}
+
+void MacCounter::merge(const MacCounter& other) {
+    for (const Entry& e : other.slots) {
+        if (e.mac != EMPTY) insert(e.mac, e.count);
+    }
+}
+
+vector<MacCounter::Entry> MacCounter::top(size_t n) const {
+    vector<Entry> all;
+    all.reserve(used);
+    for (const Entry& e : slots) {
+        if (e.mac != EMPTY) all.push_back(e);
+    }
+    n = min(n, all.size());
+    partial_sort(all.begin(), all.begin() + n, all.end(), [](const Entry& a, const Entry& b) {
+        return a.count != b.count ? a.count > b.count : a.mac < b.mac;
+    });
+    all.resize(n);
+    return all;
+}
+
+// ------------------ FrameStats ------------------
+
+const size_t FrameStats::MAX_TRACKED_PAYLOAD;
+
+FrameStats::FrameStats() : etherTypes(65536, 0), payloadLens(MAX_TRACKED_PAYLOAD + 1, 0) {
+}
+
+void FrameStats::add(const FrameInfo& f) {
+    ++frames;
+    accepted += f.accepted() ? 1 : 0;
+    crcMismatch += (f.fcs != f.calc) ? 1 : 0;
+    shortPayload += (f.payloadLen < ETH_MIN_PAYLOAD) ? 1 : 0;
+    longPayload += (f.payloadLen > ETH_MAX_PAYLOAD) ? 1 : 0;
+    frameBytes += (uint64_t)(f.frameLen - (size_t)(f.header - f.frame));
+    ++etherTypes[f.etherType & 0xFFFF];
+    ++payloadLens[min(f.payloadLen, MAX_TRACKED_PAYLOAD)];
+    sources.add(f.header + 6);
+    destinations.add(f.header);
+}
+
+void FrameStats::merge(const FrameStats& other) {
+    frames += other.frames;
+    accepted += other.accepted;
+    crcMismatch += other.crcMismatch;
+    shortPayload += other.shortPayload;
+    longPayload += other.longPayload;
+    frameBytes += other.frameBytes;
+    for (size_t i = 0; i < etherTypes.size(); ++i) {
+        etherTypes[i] += other.etherTypes[i];
+    }
+    for (size_t i = 0; i < payloadLens.size(); ++i) {
+        payloadLens[i] += other.payloadLens[i];
+    }
+    sources.merge(other.sources);
+    destinations.merge(other.destinations);
+}
+
+void FrameStats::print(TextBuffer& out, uint64_t inputBytes, double seconds) const {
+    const char* rule = "------------------------------------------\n";
+
+    out.put("ͳϢ\n").put(rule);
+    out.put("֡:         ").dec(frames).put('\n');
+    out.put(" (Accept):  ").dec(accepted).put('\n');
+    out.put("ܾ (Reject):  ").dec(frames - accepted).put('\n');
+    out.put("  CRC ƥ:   ").dec(crcMismatch).put('\n');
+    out.put("  ֶι: ").dec(shortPayload).put(" (С ").dec(ETH_MIN_PAYLOAD).put(" ֽ)\n");
+    out.put("  ֶι: ").dec(longPayload).put(" ( ").dec(ETH_MAX_PAYLOAD).put(" ֽ)\n");
+    out.put("ֽ֡:       ").dec(frameBytes).put('\n');
+    out.put("ֽ:     ").dec(inputBytes).put('\n');
+    out.put("ʱ:           ");
+    fixed1(out, seconds * 1000);
+    out.put(" \n");
+    out.put("ٶ:       ");
+    fixed1(out, seconds > 0 ? (double)inputBytes / seconds / (1024 * 1024) : 0);
+    out.put(" MiB/s\n").put(rule);
+
+    out.put("ֶηֲ:\n");
+    // С 0x0600 ֵ 802.3 ֡ĳֶΣϲΪһ
+    uint64_t lengthFrames = 0;
+    for (size_t t = 0; t < ETH_TYPE_MIN; ++t) {
+        lengthFrames += etherTypes[t];
+    }
+    if (lengthFrames > 0) {
+        out.put("  <0x").hex((uint32_t)ETH_TYPE_MIN, 4).put(" 802.3 ").dec(lengthFrames, 12, ' ').put("  ");
+        percent(out, lengthFrames, frames);
+        out.put('\n');
+    }
+    for (size_t t = ETH_TYPE_MIN; t < etherTypes.size(); ++t) {
+        if (etherTypes[t] == 0) continue;
+        const char* name = etherTypeName((unsigned int)t);
+        out.put("  0x").hex((uint32_t)t, 4).put("  ").field(name, strlen(name), 10);
+        out.dec(etherTypes[t], 12, ' ').put("  ");
+        percent(out, etherTypes[t], frames);
+        out.put('\n');
+    }
+    out.put(rule);
+
+    out.put("ֶγȷֲ (ֽ):\n");
+    for (const LengthBucket& b : LENGTH_BUCKETS) {
+        uint64_t n = 0;
+        for (size_t len = b.lo; len <= b.hi && len < payloadLens.size(); ++len) {
+            n += payloadLens[len];
+        }
+        out.put("  ");
+        if (b.hi == ~(size_t)0) {
+            out.fill(' ', 6).put("> ").dec(ETH_MAX_PAYLOAD, 4, ' ');
+        }
+        else {
+            out.dec(b.lo, 5, ' ').put(" - ").dec(b.hi, 4, ' ');
+        }
+        out.dec(n, 12, ' ').put("  ");
+        percent(out, n, frames);
+        out.put('\n');
+    }
+    out.put(rule);
+
+    printTop(out, "Դַ Top 10", sources, frames);
+    out.put(rule);
+    printTop(out, "Ŀĵַ Top 10", destinations, frames);
+    out.put(rule);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "FrameDecoder.h"
+#include "../Common/TextBuffer.h"
+
+// ------------------ ͳģʽ ------------------
+
+/**
+ * @brief  MAC ַĿѰַϣ̽⣩Ϊ48λַɵ
+ */
+class MacCounter {
+public:
+    struct Entry {
+        uint64_t mac;   // ַ16λΪ0
+        uint64_t count; // ֡
+    };
+
+    MacCounter();
+
+    /**
+     * @brief ַӦļ n
+     */
+    void add(const uint8_t* addr, uint64_t n = 1);
+
+    /**
+     * @brief һűļϲ
+     */
+    void merge(const MacCounter& other);
+
+    /**
+     * @brief ֡Ӷൽȡǰ n ַ
+     */
+    std::vector<Entry> top(size_t n) const;
+
+    size_t size() const {
+        return used;
+    }
+
+private:
+    static const uint64_t EMPTY = ~(uint64_t)0; // ղ۱ǣֵܳĵֵַ
+
+    void insert(uint64_t mac, uint64_t n);
+    void grow();
+
+    std::vector<Entry> slots; // Ϊ2
+    size_t used = 0;
+};
+
+/**
+ * @brief ֡ͳƣȫڶУỵ̈߳λۼӣʱٺϲ
+ */
+class FrameStats {
+public:
+    // ֽͳƵֶγޣļһ
+    static const size_t MAX_TRACKED_PAYLOAD = ETH_MAX_PAYLOAD + 1;
+
+    FrameStats();
+
+    /**
+     * @brief ۼһ֡
+     */
+    void add(const FrameInfo& f);
+
+    /**
+     * @brief һͳƺϲ
+     */
+    void merge(const FrameStats& other);
+
+    /**
+     * @brief ͳƱ
+     * @param out 
+     * @param inputBytes ֽ
+     * @param seconds ʱ룩
+     */
+    void print(TextBuffer& out, uint64_t inputBytes, double seconds) const;
+
+private:
+    uint64_t frames = 0;
+    uint64_t accepted = 0;
+    uint64_t crcMismatch = 0;
+    uint64_t shortPayload = 0; // ֶ < ETH_MIN_PAYLOAD
+    uint64_t longPayload = 0;  // ֶ > ETH_MAX_PAYLOAD
+    uint64_t frameBytes = 0;   // ֡ͷ + ֶ + FCS
+    std::vector<uint64_t> etherTypes;  // ±ΪֶΣ65536 
+    std::vector<uint64_t> payloadLens; // ±ΪֶγȣMAX_TRACKED_PAYLOAD + 1 
+    MacCounter sources;
+    MacCounter destinations;
+};
@@ -0,0 +1,337 @@
+// ʹ fopen ȴͳ CRT 
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "InputSource.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+// ѴۼƳֵʱŹ黹һҳ棬Ƶϵͳ
+const uint64_t RELEASE_STEP = 64ull * 1024 * 1024;
+
+// ģʽµȴ inotify ¼ĳʱ룩ʱǷҪֹͣ
+const int FOLLOW_WAIT_MS = 200;
+// ޷ʹ inotify ʱWindows ʧܣļļ룩
+const int FOLLOW_POLL_MS = 10;
+
+volatile sig_atomic_t followStopped = 0;
+
+// ------------------ ڴӳ ------------------
+
+class MappedInput : public InputSource {
+public:
+    ~MappedInput() override {
+#ifdef _WIN32
+        if (view) UnmapViewOfFile(view);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (view) munmap(view, size);
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    /**
+     * @brief ӳļ
+     * @return ļǿӳͨļӳʧʱ false
+     */
+    bool open(const char* path) {
+#ifdef _WIN32
+        file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE || GetFileType(file) != FILE_TYPE_DISK) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) return false;
+        if ((unsigned long long)fileSize.QuadPart > (unsigned long long)SIZE_MAX) return false; // 32λ޷ӳ䳬ļ
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return false;
+        view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) return false;
+        size = (size_t)fileSize.QuadPart;
+#else
+        fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) return false;
+        if ((unsigned long long)st.st_size > (unsigned long long)SIZE_MAX) return false;
+        size = (size_t)st.st_size;
+        void* p = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return false;
+        view = p;
+        madvise(view, size, MADV_SEQUENTIAL); // ˳ȡں˿ɻԤ
+#endif
+        return true;
+    }
+
+    ByteWindow window() const override {
+        return ByteWindow{ (const unsigned char*)view, 0, size, true };
+    }
+
+    bool refill(uint64_t) override {
+        return false; // ļڴ
+    }
+
+    void release(uint64_t upTo) override {
+        if (upTo > size) upTo = size;
+        if (upTo < released + RELEASE_STEP) return;
+        const uint64_t page = 64 * 1024; // ͬʱ 4K ҳ Windows ȵĶ
+        uint64_t end = upTo / page * page;
+        if (end <= released) return;
+        unsigned char* start = (unsigned char*)view + released;
+#ifdef _WIN32
+        // δҳ VirtualUnlock ὫƳ
+        VirtualUnlock(start, (SIZE_T)(end - released));
+#else
+        madvise(start, (size_t)(end - released), MADV_DONTNEED); // ֻӳ䣬ҳԱҳ
+#endif
+        released = end;
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+    void* view = nullptr;
+    size_t size = 0;
+    uint64_t released = 0; // ѹ黹ҳĩβƫ
+};
+
+// ------------------  ------------------
+
+class StreamInput : public InputSource {
+public:
+    StreamInput(FILE* f, bool owned, size_t windowSize)
+        : fp(f), ownsFile(owned), buf(windowSize < 64 ? 64 : windowSize) {
+    }
+
+    ~StreamInput() override {
+        if (ownsFile && fp) fclose(fp);
+    }
+
+    ByteWindow window() const override {
+        return ByteWindow{ buf.data(), base, used, eof };
+    }
+
+    bool refill(uint64_t keepFrom) override {
+        if (eof) return false;
+        if (keepFrom < base) keepFrom = base;
+        size_t drop = (size_t)(keepFrom - base);
+        if (drop > used) drop = used;
+
+        // δݲƵͷ
+        size_t keep = used - drop;
+        if (drop > 0 && keep > 0) {
+            memmove(buf.data(), buf.data() + drop, keep);
+        }
+        base += drop;
+        used = keep;
+
+        // δռݴһʱ󴰿ڣ֤֡ȳʱǰ
+        if (used * 2 > buf.size()) {
+            buf.resize(buf.size() * 2);
+        }
+
+        size_t got = 0;
+        while (used < buf.size()) {
+            size_t n = fread(buf.data() + used, 1, buf.size() - used, fp);
+            if (n > 0) {
+                used += n;
+                got += n;
+                continue;
+            }
+            if (!follows()) {
+                eof = true;
+                break;
+            }
+            // ģʽļǰĩβݾȽȴļ
+            clearerr(fp);
+            if (got > 0) {
+                break;
+            }
+            if (!waitForData(base + used)) {
+                eof = true;
+                break;
+            }
+        }
+        return got > 0;
+    }
+
+    void release(uint64_t) override {
+        //  refill ʱݣ⴦
+    }
+
+protected:
+    /**
+     * @brief ĩβʱǷȴļǽ
+     */
+    virtual bool follows() const {
+        return false;
+    }
+
+    /**
+     * @brief ȴļ
+     * @param readEnd Ѷݵĩβƫ
+     * @return Ҫֹͣʱ false
+     */
+    virtual bool waitForData(uint64_t readEnd) {
+        (void)readEnd;
+        return false;
+    }
+
+    FILE* file() const {
+        return fp;
+    }
+
+private:
+    FILE* fp;
+    bool ownsFile;
+    vector<unsigned char> buf;
+    uint64_t base = 0; // buf[0] еƫ
+    size_t used = 0;   // buf еЧֽ
+    bool eof = false;
+};
+
+// ------------------  ------------------
+
+/**
+ * @brief ļĩβʱȴݣLinux ʹ inotifyƽ̨ʱѯ
+ *        ֱ stopFollowing() ûļض
+ */
+class FollowInput : public StreamInput {
+public:
+    FollowInput(FILE* f, const char* path, size_t windowSize)
+        : StreamInput(f, true, windowSize) {
+#ifndef _WIN32
+        notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (notifyFd >= 0 && inotify_add_watch(notifyFd, path, IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF) < 0) {
+            close(notifyFd);
+            notifyFd = -1; // ޷ʱ˻ضʱѯ
+        }
+#else
+        (void)path;
+#endif
+    }
+
+    ~FollowInput() override {
+#ifndef _WIN32
+        if (notifyFd >= 0) close(notifyFd);
+#endif
+    }
+
+protected:
+    bool follows() const override {
+        return true;
+    }
+
+    bool waitForData(uint64_t readEnd) override {
+        if (followStopped) {
+            return false;
+        }
+        if (truncated(readEnd)) {
+            cerr << "ļضϻ滻ֹͣ" << endl;
+            return false;
+        }
+#ifdef _WIN32
+        Sleep(FOLLOW_POLL_MS);
+#else
+        if (notifyFd < 0) {
+            usleep(FOLLOW_POLL_MS * 1000);
+            return !followStopped;
+        }
+        // ļдѣʱֻΪ˶ڼֹͣ־źҲ poll
+        pollfd pfd{ notifyFd, POLLIN, 0 };
+        if (poll(&pfd, 1, FOLLOW_WAIT_MS) > 0) {
+            char events[4096];
+            while (read(notifyFd, events, sizeof(events)) > 0) {
+            }
+        }
+#endif
+        return !followStopped;
+    }
+
+private:
+    /**
+     * @brief ļǰСǷСѶȡλ
+     */
+    bool truncated(uint64_t readEnd) const {
+#ifdef _WIN32
+        struct _stat64 st;
+        return _fstat64(_fileno(file()), &st) == 0 && (uint64_t)st.st_size < readEnd;
+#else
+        struct stat st;
+        return fstat(fileno(file()), &st) == 0 && (uint64_t)st.st_size < readEnd;
+#endif
+    }
+
+#ifndef _WIN32
+    int notifyFd = -1;
+#endif
+};
+
+} // namespace
+
+unique_ptr<InputSource> openFollowInput(const char* path, size_t windowSize) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        return nullptr;
+    }
+    unique_ptr<InputSource> in(new FollowInput(fp, path, windowSize));
+    in->refill(0);
+    return in;
+}
+
+void stopFollowing() {
+    followStopped = 1;
+}
+
+unique_ptr<InputSource> openInput(const char* path, size_t windowSize) {
+    if (strcmp(path, "-") == 0) {
+#ifdef _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+#endif
+        unique_ptr<InputSource> in(new StreamInput(stdin, false, windowSize));
+        in->refill(0);
+        return in;
+    }
+
+    unique_ptr<MappedInput> mapped(new MappedInput());
+    if (mapped->open(path)) {
+        return unique_ptr<InputSource>(mapped.release());
+    }
+    mapped.reset();
+
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        return nullptr;
+    }
+    unique_ptr<InputSource> in(new StreamInput(fp, true, windowSize));
+    in->refill(0);
+    return in;
+}
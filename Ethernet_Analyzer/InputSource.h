@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// ------------------ Դ ------------------
+
+/**
+ * @brief ǰֱӷʵһ
+ */
+struct ByteWindow {
+    const unsigned char* data; // ֽ
+    uint64_t base;             // ֽеƫ
+    size_t size;               // еֽ
+    bool eof;                  // ֮Ƿûи
+};
+
+/**
+ * @brief ֡ݵԴ
+ *
+ * ͨļӳ䵽ڴ棬ڼļܵ׼޷ӳ
+ * ʹù̶СĻζȡֻͨڷݣ
+ * ڴռļС޹ء
+ */
+class InputSource {
+public:
+    virtual ~InputSource() = default;
+
+    /**
+     * @brief ȡǰ
+     */
+    virtual ByteWindow window() const = 0;
+
+    /**
+     * @brief  keepFrom ֮ǰݲ
+     * @param keepFrom 豣ĵһֽڵƫ
+     * @return ݷ trueѵĩβ false˺󴰿ڵ eof Ϊ true
+     */
+    virtual bool refill(uint64_t keepFrom) = 0;
+
+    /**
+     * @brief ֪ upTo ֮ǰѲҪӳݴ˹黹Ѷҳ
+     * @param upTo Ѵĩβƫ
+     */
+    virtual void release(uint64_t upTo) = 0;
+};
+
+// ڵĳʼС֡ȳʱڻᰴ
+const size_t INPUT_WINDOW_SIZE = 4 * 1024 * 1024;
+
+/**
+ * @brief 룺ͨļʹڴӳ䣬ӳʧܣ˵ڶȡ
+ * @param path ļ·"-" ʾ׼
+ * @param windowSize ڵĳʼС
+ * @return ʧʱ nullptr
+ */
+std::unique_ptr<InputSource> openInput(const char* path, size_t windowSize = INPUT_WINDOW_SIZE);
+
+/**
+ * @brief Ըģʽ򿪳ļĩβʱȴݶǽ
+ *        δ֡ڴУݲӸ֡
+ * @param path ļ·
+ * @param windowSize ڵĳʼС
+ * @return ʧʱ nullptr
+ */
+std::unique_ptr<InputSource> openFollowInput(const char* path, size_t windowSize = INPUT_WINDOW_SIZE);
+
+/**
+ * @brief ֹ֪ͨͣȴźŴеã˺󴰿ڵ eof Ϊ true
+ */
+void stopFollowing();
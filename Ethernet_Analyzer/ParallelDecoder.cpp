@@ -0,0 +1,255 @@
+#include "ParallelDecoder.h"
+#include "FrameScanner.h"
+#include "FrameDecoder.h"
+#include "FrameReport.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// ÿ֡
+const size_t TASK_BYTES = 256 * 1024;
+
+/**
+ * @brief ţ߳ɵο򵽴д
+ *
+ * ÿεдһ黺Уд󻺳ոʹá
+ */
+class OrderedWriter {
+public:
+    /**
+     * @param r 
+     * @param maxPending ͬʱ;ѷ䵫δдڴռ
+     */
+    OrderedWriter(const FrameReporter& r, size_t maxPending)
+        : reporter(r), limit(maxPending), writer(&OrderedWriter::run, this) {
+    }
+
+    ~OrderedWriter() {
+        finish();
+    }
+
+    /**
+     * @brief һţ;δﵽʱȴ
+     */
+    uint64_t acquire() {
+        unique_lock<mutex> lk(mtx);
+        cv.wait(lk, [this] { return inFlight < limit; });
+        ++inFlight;
+        return issued++;
+    }
+
+    /**
+     * @brief ȡһյĻڸʽһ
+     */
+    unique_ptr<ReportBuffers> takeBuffer() {
+        lock_guard<mutex> lk(mtx);
+        if (spare.empty()) {
+            return unique_ptr<ReportBuffers>(new ReportBuffers());
+        }
+        unique_ptr<ReportBuffers> tb = move(spare.back());
+        spare.pop_back();
+        return tb;
+    }
+
+    /**
+     * @brief ύһε
+     * @param seq 
+     * @param text ı
+     * @param endOffset һ֡Ľλеƫ
+     */
+    void put(uint64_t seq, unique_ptr<ReportBuffers> text, uint64_t endOffset) {
+        {
+            lock_guard<mutex> lk(mtx);
+            ready.emplace(seq, Batch{ move(text), endOffset });
+        }
+        cv.notify_all();
+    }
+
+    /**
+     * @brief ȴѷд߳
+     */
+    void finish() {
+        {
+            lock_guard<mutex> lk(mtx);
+            if (closing) return;
+            closing = true;
+        }
+        cv.notify_all();
+        writer.join();
+    }
+
+    /**
+     * @brief ȫfinish() ֮ãʱлѻ
+     */
+    vector<unique_ptr<ReportBuffers>>& buffers() {
+        return spare;
+    }
+
+    /**
+     * @brief деĽƫ
+     */
+    uint64_t writtenUpTo() const {
+        return written.load(memory_order_acquire);
+    }
+
+private:
+    struct Batch {
+        unique_ptr<ReportBuffers> text;
+        uint64_t endOffset;
+    };
+
+    void run() {
+        unique_lock<mutex> lk(mtx);
+        for (;;) {
+            cv.wait(lk, [this] {
+                return (!ready.empty() && ready.begin()->first == next) || (closing && inFlight == 0);
+            });
+            if (ready.empty() || ready.begin()->first != next) {
+                return; // ȫд
+            }
+            Batch b = move(ready.begin()->second);
+            ready.erase(ready.begin());
+            lk.unlock();
+            reporter.write(*b.text);
+            written.store(b.endOffset, memory_order_release);
+            lk.lock();
+            spare.push_back(move(b.text));
+            ++next;
+            --inFlight;
+            cv.notify_all();
+        }
+    }
+
+    const FrameReporter& reporter;
+    const size_t limit;
+    mutex mtx;
+    condition_variable cv;
+    map<uint64_t, Batch> ready; // ɵδֵд
+    vector<unique_ptr<ReportBuffers>> spare; // дɸõĻ
+    uint64_t issued = 0;        // һ
+    uint64_t next = 0;          // һҪд
+    size_t inFlight = 0;
+    bool closing = false;
+    atomic<uint64_t> written{ 0 };
+    thread writer;
+};
+
+} // namespace
+
+int analyzeParallel(InputSource& in, CaptureReader* capture, FcsType fcsType, unsigned int jobs, FrameReporter& reporter) {
+    if (jobs == 0) jobs = 1;
+    WorkerPool pool(jobs);
+    OrderedWriter writer(reporter, (size_t)jobs * 4);
+    TaskGroup scanGroup;   // ǰݵǰ
+    TaskGroup decodeGroup; // õǰڵĽ
+
+    uint64_t filePos = 0;
+    int frameCount = 0;
+    const size_t batchBase = SCAN_BATCH * jobs;
+    size_t scanBatch = batchBase;
+    vector<vector<size_t>> chunkMarks(jobs);
+    vector<size_t> marks;
+    vector<FrameSpan> spans;
+
+    for (;;) {
+        const ByteWindow win = in.window();
+        const unsigned char* data = win.data;
+        const size_t pos = (size_t)(filePos - win.base);
+        const size_t scanEnd = (win.size - pos > scanBatch) ? pos + scanBatch : win.size;
+        const bool atEnd = win.eof && scanEnd == win.size;
+
+        spans.clear();
+        size_t resume;
+        if (capture) {
+            // 1. ץļ¼ͷ˳תɻ֣Сڱ߳
+            resume = capture->split(data, scanEnd, pos, atEnd, spans);
+        }
+        else {
+            // 1. ̲߳һеǰ룻ÿ࿴7ֽڣڱڵǰ붼ɱ鸺
+            const size_t chunk = (scanEnd - pos + jobs - 1) / jobs;
+            for (unsigned int i = 0; i < jobs; ++i) {
+                chunkMarks[i].clear();
+                size_t lo = pos + chunk * i;
+                if (chunk == 0 || lo >= scanEnd) continue;
+                size_t hi = min(lo + chunk + 7, scanEnd);
+                vector<size_t>* dst = &chunkMarks[i];
+                pool.submit(scanGroup, [data, hi, lo, dst] { findPreambles(data, hi, lo, *dst); });
+            }
+            scanGroup.wait();
+
+            marks.clear();
+            for (const auto& m : chunkMarks) {
+                marks.insert(marks.end(), m.begin(), m.end());
+            }
+            resume = marksToSpans(marks, scanEnd, pos, atEnd, spans);
+        }
+        const bool packets = capture != nullptr;
+        const bool checkFcs = reporter.fcsOnDecode();
+
+        // 2. ˳źȷ̵߳뵥߳һ
+        size_t i = 0;
+        while (i < spans.size()) {
+            size_t j = i;
+            size_t bytes = 0;
+            int valid = 0;
+            while (j < spans.size() && bytes < TASK_BYTES) {
+                bytes += spans[j].end - spans[j].start;
+                if (packets ? packetSpanValid(spans[j], fcsType) : frameSpanValid(spans[j], fcsType)) ++valid;
+                ++j;
+            }
+            if (valid > 0) {
+                auto batch = make_shared<vector<FrameSpan>>(spans.begin() + i, spans.begin() + j);
+                const int firstNumber = frameCount + 1;
+                const uint64_t base = win.base;
+                const uint64_t endOffset = base + spans[j - 1].end;
+                const uint64_t seq = writer.acquire();
+                OrderedWriter* w = &writer;
+                pool.submit(decodeGroup, [data, batch, base, firstNumber, endOffset, seq, fcsType, packets, checkFcs, &reporter, w] {
+                    unique_ptr<ReportBuffers> text = w->takeBuffer();
+                    FrameInfo f;
+                    int number = firstNumber;
+                    for (const FrameSpan& span : *batch) {
+                        const bool ok = packets
+                            ? decodePacket(data, span, fcsType, f, checkFcs)
+                            : decodeFrame(data, span, fcsType, f, checkFcs);
+                        if (ok) {
+                            reporter.frame(*text, f, number++, base + span.start);
+                        }
+                    }
+                    w->put(seq, move(text), endOffset);
+                });
+                frameCount += valid;
+            }
+            i = j;
+        }
+
+        filePos = win.base + resume;
+        if (atEnd) {
+            break;
+        }
+        in.release(min(writer.writtenUpTo(), filePos));
+        if (scanEnd < win.size) {
+            scanBatch = (resume > pos) ? batchBase : scanBatch * 2;
+            continue;
+        }
+        // ݻƶڣȵõǰڵȫ
+        decodeGroup.wait();
+        in.refill(filePos);
+    }
+
+    decodeGroup.wait();
+    writer.finish();
+    for (auto& b : writer.buffers()) {
+        reporter.collect(*b);
+    }
+    return frameCount;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "InputSource.h"
+#include "Checksum.h"
+#include "FrameReport.h"
+#include "CaptureFile.h"
+
+// ------------------ ߳̽ ------------------
+
+/**
+ * @brief ߳̽еȫ֡ԭʼ˳
+ *
+ * 밴齻̲߳ǰ룬֮ص7ֽڣǰҲҵ
+ * ϲ֡˳š߳̽У飬̰߳źд
+ * 뵥ֽ߳һ¡
+ * @param in Դ
+ * @param capture ץļļ¼ȡ¼ͷ߳˳򻮷֣ԭʼ֡ļΪ nullptr
+ * @param fcsType ֡βУ㷨
+ * @param jobs ߳
+ * @param reporter 
+ * @return Ч֡
+ */
+int analyzeParallel(InputSource& in, CaptureReader* capture, FcsType fcsType, unsigned int jobs, FrameReporter& reporter);
@@ -0,0 +1,65 @@
+#include "WorkerPool.h"
+
+using namespace std;
+
+void TaskGroup::wait() {
+    unique_lock<mutex> lk(mtx);
+    cv.wait(lk, [this] { return pending == 0; });
+}
+
+void TaskGroup::add() {
+    lock_guard<mutex> lk(mtx);
+    ++pending;
+}
+
+void TaskGroup::done() {
+    lock_guard<mutex> lk(mtx);
+    if (--pending == 0) {
+        cv.notify_all();
+    }
+}
+
+WorkerPool::WorkerPool(unsigned int count) {
+    if (count == 0) count = 1;
+    threads.reserve(count);
+    for (unsigned int i = 0; i < count; ++i) {
+        threads.emplace_back(&WorkerPool::run, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        lock_guard<mutex> lk(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& th : threads) {
+        th.join();
+    }
+}
+
+void WorkerPool::submit(TaskGroup& group, function<void()> task) {
+    group.add();
+    {
+        lock_guard<mutex> lk(mtx);
+        queue.push_back(Task{ &group, move(task) });
+    }
+    cv.notify_one();
+}
+
+void WorkerPool::run() {
+    for (;;) {
+        Task task;
+        {
+            unique_lock<mutex> lk(mtx);
+            cv.wait(lk, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return; // Ҫֹͣûʣ
+            }
+            task = move(queue.front());
+            queue.pop_front();
+        }
+        task.fn();
+        task.group->done();
+    }
+}
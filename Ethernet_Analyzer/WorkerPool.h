@@ -0,0 +1,78 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ------------------ ̳߳ ------------------
+
+/**
+ * @brief һɼڵȴĳһύȫ
+ */
+class TaskGroup {
+public:
+    /**
+     * @brief ֱύȫ
+     */
+    void wait();
+
+private:
+    friend class WorkerPool;
+    void add();
+    void done();
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    size_t pending = 0;
+};
+
+/**
+ * @brief ̶̵̳߳߳أύ˳ȡִ
+ */
+class WorkerPool {
+public:
+    /**
+     * @param threads ߳Ϊ1
+     */
+    explicit WorkerPool(unsigned int threads);
+
+    /**
+     * @brief ִύȫ߳
+     */
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief ύһ
+     * @param group 飬ʱһ
+     * @param task 
+     */
+    void submit(TaskGroup& group, std::function<void()> task);
+
+    /**
+     * @brief ߳
+     */
+    unsigned int size() const {
+        return (unsigned int)threads.size();
+    }
+
+private:
+    struct Task {
+        TaskGroup* group;
+        std::function<void()> fn;
+    };
+
+    void run();
+
+    std::vector<std::thread> threads;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<Task> queue;
+    bool stopping = false;
+};
@@ -0,0 +1,399 @@
+// ʹ fopen ȴͳ CRT 
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include "../Ethernet_Analyzer/Checksum.h"
+#include "../Common/TextBuffer.h"
+
+using namespace std;
+
+// ------------------ ֡ļʽ ------------------
+//  Ethernet_Analyzer ȡԭʼ֡ļһ£
+//   ǰ 7 x 0xAA | ֡ǰ 0xAB | Ŀĵַ 6 | Դַ 6 | ֶ 2 | ֶ | FCS (CRC-8 1ֽڻ CRC-32 4ֽ)
+
+const unsigned char PREAMBLE[8] = { 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAB };
+const size_t ETH_HEADER_LEN = 14;
+const size_t MIN_PAYLOAD = 46;
+const size_t MAX_PAYLOAD = 1500;
+const size_t MAX_GARBAGE = 64; // ֡ݵ󳤶
+
+// ------------------ в ------------------
+
+/**
+ * @brief Ȩصֶ
+ */
+struct TypeWeight {
+    uint16_t type;
+    unsigned int weight;
+};
+
+/**
+ * @brief ֶγȷֲ
+ */
+enum class PayloadMix {
+    Uniform, // [payloadMin, payloadMax] ȷֲ
+    Imix     //  IMIX46 / 576 / 1500 ֽڰ 7:4:1
+};
+
+/**
+ * @brief ѡ
+ */
+struct Options {
+    const char* path = nullptr;   // ļ·"-" ʾ׼
+    uint64_t frames = 0;          // ֡Ϊ0ʱ bytes 
+    uint64_t bytes = 0;           // Ĵֽ
+    FcsType fcs = FcsType::Crc8;  // ֡βУ㷨
+    PayloadMix mix = PayloadMix::Uniform;
+    size_t payloadMin = MIN_PAYLOAD;
+    size_t payloadMax = MAX_PAYLOAD;
+    vector<TypeWeight> types{ { 0x0800, 70 }, { 0x86DD, 20 }, { 0x0806, 10 } };
+    double badCrc = 0;            // CRC ֡ռ
+    double truncated = 0;         // ضϵ֡ռ
+    double garbage = 0;           // ݵ֡ռ
+    uint64_t seed = 1;            // ӣͬͬļ
+};
+
+/**
+ * @brief ӡ÷˵
+ * @param prog 
+ */
+void printUsage(const char* prog) {
+    cout << "÷: " << prog << " [ѡ] ļ·" << endl;
+    cout << " Ethernet_Analyzer ʹõԭʼ֡ļܲԣļ·Ϊ - ʱд׼" << endl;
+    cout << "ѡ:" << endl;
+    cout << "  --frames=N          N ֡" << endl;
+    cout << "  --size=BYTES       Լ BYTES ֽڣɼ K/M/G ׺δָ֡ʱĬ 64M" << endl;
+    cout << "  --fcs=crc8|crc32   ֡βУ㷨Ĭ crc8" << endl;
+    cout << "  --payload=MIN-MAX  ֶγ [MIN, MAX] ھȷֲĬ 46-1500ֵʾ" << endl;
+    cout << "  --payload=imix     ֶγȰ 46 / 576 / 1500 ֽ 7:4:1 ֲ" << endl;
+    cout << "  --types=T:W,...    ֶμȨأ 0x0800:70,0x86DD:20,0x0806:10Ĭֵ" << endl;
+    cout << "  --bad-crc=P        FCS ֡ռ (0~1)" << endl;
+    cout << "  --truncated=P      ֡λýضϵ֡ռ (0~1)" << endl;
+    cout << "  --garbage=P        ֡ݣǰ룩ı (0~1)" << endl;
+    cout << "  --seed=N           ӣĬ 1" << endl;
+}
+
+/**
+ * @brief  K/M/G ׺ֽ
+ */
+bool parseSize(const char* s, uint64_t& out) {
+    char* end = nullptr;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (end == s) return false;
+    switch (*end) {
+    case 'k': case 'K': v <<= 10; ++end; break;
+    case 'm': case 'M': v <<= 20; ++end; break;
+    case 'g': case 'G': v <<= 30; ++end; break;
+    default: break;
+    }
+    out = v;
+    return *end == '\0' && v > 0;
+}
+
+/**
+ * @brief  0~1 ֮ı
+ */
+bool parseRatio(const char* s, double& out) {
+    char* end = nullptr;
+    out = strtod(s, &end);
+    return end != s && *end == '\0' && out >= 0 && out <= 1;
+}
+
+/**
+ * @brief  --payload Ĳ
+ */
+bool parsePayload(const char* s, Options& opt) {
+    if (strcmp(s, "imix") == 0) {
+        opt.mix = PayloadMix::Imix;
+        return true;
+    }
+    char* end = nullptr;
+    const unsigned long lo = strtoul(s, &end, 10);
+    if (end == s) return false;
+    unsigned long hi = lo;
+    if (*end == '-') {
+        const char* second = end + 1;
+        hi = strtoul(second, &end, 10);
+        if (end == second) return false;
+    }
+    if (*end != '\0' || hi < lo || hi > 65535) return false;
+    opt.mix = PayloadMix::Uniform;
+    opt.payloadMin = lo;
+    opt.payloadMax = hi;
+    return true;
+}
+
+/**
+ * @brief  --types Ĳŷָ :ȨأȨʡʱΪ1
+ */
+bool parseTypes(const char* s, Options& opt) {
+    vector<TypeWeight> types;
+    while (*s) {
+        char* end = nullptr;
+        const unsigned long type = strtoul(s, &end, 0);
+        if (end == s || type > 0xFFFF) return false;
+        unsigned long weight = 1;
+        if (*end == ':') {
+            const char* w = end + 1;
+            weight = strtoul(w, &end, 10);
+            if (end == w || weight == 0) return false;
+        }
+        types.push_back(TypeWeight{ (uint16_t)type, (unsigned int)weight });
+        if (*end == ',') ++end;
+        else if (*end != '\0') return false;
+        s = end;
+    }
+    if (types.empty()) return false;
+    opt.types.swap(types);
+    return true;
+}
+
+/**
+ * @brief в
+ * @return 󷵻 false
+ */
+bool parseArgs(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        const size_t eq = arg.find('=');
+        const string name = arg.substr(0, eq);
+        const char* value = (eq == string::npos) ? "" : argv[i] + eq + 1;
+        bool ok = true;
+        if (name == "--frames") {
+            ok = parseSize(value, opt.frames);
+        }
+        else if (name == "--size") {
+            ok = parseSize(value, opt.bytes);
+        }
+        else if (arg == "--fcs=crc8") {
+            opt.fcs = FcsType::Crc8;
+        }
+        else if (arg == "--fcs=crc32") {
+            opt.fcs = FcsType::Crc32;
+        }
+        else if (name == "--payload") {
+            ok = parsePayload(value, opt);
+        }
+        else if (name == "--types") {
+            ok = parseTypes(value, opt);
+        }
+        else if (name == "--bad-crc") {
+            ok = parseRatio(value, opt.badCrc);
+        }
+        else if (name == "--truncated") {
+            ok = parseRatio(value, opt.truncated);
+        }
+        else if (name == "--garbage") {
+            ok = parseRatio(value, opt.garbage);
+        }
+        else if (name == "--seed") {
+            char* end = nullptr;
+            opt.seed = strtoull(value, &end, 10);
+            ok = end != value && *end == '\0';
+        }
+        else if (arg.size() > 1 && arg[0] == '-') {
+            cerr << "δ֪ѡ: " << arg << endl;
+            return false;
+        }
+        else if (opt.path == nullptr) {
+            opt.path = argv[i];
+        }
+        else {
+            cerr << "ָֻһļ" << endl;
+            return false;
+        }
+        if (!ok) {
+            cerr << "Ч: " << arg << endl;
+            return false;
+        }
+    }
+    if (opt.path == nullptr) {
+        cerr << "δָļ" << endl;
+        return false;
+    }
+    if (opt.frames == 0 && opt.bytes == 0) {
+        opt.bytes = 64ull << 20;
+    }
+    return true;
+}
+
+// ------------------ ֡ ------------------
+
+/**
+ * @brief ѡ֡
+ */
+class FrameGenerator {
+public:
+    explicit FrameGenerator(const Options& o) : opt(o), rng(o.seed), frame(ETH_HEADER_LEN + 65535 + 4) {
+        for (const TypeWeight& t : opt.types) {
+            totalWeight += t.weight;
+        }
+    }
+
+    /**
+     * @brief һܱ֡ضϡݣ׷ӵ out
+     */
+    void next(TextBuffer& out) {
+        const size_t payloadLen = payloadLength();
+        const size_t fcsLen = fcsLength(opt.fcs);
+        unsigned char* p = frame.data();
+
+        fillRandom(p, 12); // ĿĵַԴַ
+        const uint16_t type = etherType();
+        p[12] = (unsigned char)(type >> 8);
+        p[13] = (unsigned char)type;
+        fillRandom(p + ETH_HEADER_LEN, payloadLen);
+
+        const size_t bodyLen = ETH_HEADER_LEN + payloadLen;
+        uint32_t fcs = calcFcs(opt.fcs, p, bodyLen);
+        if (chance(opt.badCrc)) {
+            fcs ^= 1u << (rng() % (fcsLen * 8)); // תһλ֤ȷֵͬ
+            ++badCrcFrames;
+        }
+        for (size_t i = 0; i < fcsLen; ++i) {
+            p[bodyLen + i] = (unsigned char)(fcs >> (8 * i)); // CRC-32 С˳
+        }
+
+        size_t len = bodyLen + fcsLen;
+        if (chance(opt.truncated)) {
+            len = (size_t)(rng() % len); // ض֡λã֡ͷ
+            ++truncatedFrames;
+        }
+        out.put((const char*)PREAMBLE, sizeof(PREAMBLE));
+        out.put((const char*)p, len);
+
+        if (chance(opt.garbage)) {
+            appendGarbage(out);
+            ++garbageRuns;
+        }
+        ++frames;
+    }
+
+    uint64_t frames = 0;
+    uint64_t badCrcFrames = 0;
+    uint64_t truncatedFrames = 0;
+    uint64_t garbageRuns = 0;
+
+private:
+    bool chance(double p) {
+        return p > 0 && uniform(rng) < p;
+    }
+
+    void fillRandom(unsigned char* p, size_t n) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            const uint64_t v = rng();
+            memcpy(p + i, &v, 8);
+        }
+        if (i < n) {
+            const uint64_t v = rng();
+            memcpy(p + i, &v, n - i);
+        }
+    }
+
+    size_t payloadLength() {
+        if (opt.mix == PayloadMix::Imix) {
+            const unsigned int r = (unsigned int)(rng() % 12);
+            return r < 7 ? MIN_PAYLOAD : (r < 11 ? 576 : MAX_PAYLOAD);
+        }
+        return opt.payloadMin + (size_t)(rng() % (opt.payloadMax - opt.payloadMin + 1));
+    }
+
+    uint16_t etherType() {
+        uint64_t r = rng() % totalWeight;
+        for (const TypeWeight& t : opt.types) {
+            if (r < t.weight) return t.type;
+            r -= t.weight;
+        }
+        return opt.types.back().type;
+    }
+
+    /**
+     * @brief ݣֽڣпܼһβǰ룬ڿ߽
+     */
+    void appendGarbage(TextBuffer& out) {
+        unsigned char junk[MAX_GARBAGE];
+        const size_t n = 1 + (size_t)(rng() % MAX_GARBAGE);
+        fillRandom(junk, n);
+        if (rng() % 2 == 0) {
+            const size_t run = min(n, 1 + (size_t)(rng() % 6)); // 7 0xAAǰ
+            memset(junk, 0xAA, run);
+            if (run < n && junk[run] == 0xAB) junk[run] = 0;
+        }
+        out.put((const char*)junk, n);
+    }
+
+    const Options& opt;
+    mt19937_64 rng;
+    uniform_real_distribution<double> uniform{ 0.0, 1.0 };
+    vector<unsigned char> frame;
+    uint64_t totalWeight = 0;
+};
+
+// ------------------  ------------------
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 0;
+    }
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    FILE* fp = nullptr;
+    const bool toStdout = strcmp(opt.path, "-") == 0;
+    if (toStdout) {
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    }
+    else if (!(fp = fopen(opt.path, "wb"))) {
+        cerr << "޷ļ: " << opt.path << endl;
+        return 1;
+    }
+
+    FrameGenerator gen(opt);
+    TextBuffer out;
+    uint64_t written = 0;
+    bool failed = false;
+    auto emit = [&]() {
+        written += out.size();
+        if (toStdout) {
+            out.flush();
+            return;
+        }
+        failed |= fwrite(out.data(), 1, out.size(), fp) != out.size();
+        out.clear();
+    };
+    while (opt.frames ? gen.frames < opt.frames : written + out.size() < opt.bytes) {
+        gen.next(out);
+        if (out.size() >= TextBuffer::FLUSH_SIZE) emit();
+    }
+    emit();
+    if (fp) failed |= fclose(fp) != 0;
+    if (failed) {
+        cerr << "дļʧ: " << opt.path << endl;
+        return 1;
+    }
+
+    cerr << " " << gen.frames << " ֡, " << written << " ֽ"
+         << " (FCS  " << gen.badCrcFrames << ", ض " << gen.truncatedFrames
+         << ",  " << gen.garbageRuns << ")" << endl;
+    return 0;
+}
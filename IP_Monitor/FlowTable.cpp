@@ -0,0 +1,81 @@
+#include "FlowTable.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+inline size_t hashFlow(uint64_t addrs, uint64_t rest) {
+    uint64_t h = addrs * 0x9E3779B97F4A7C15ull ^ rest; // ˷ɢУλϽϺ
+    h *= 0xBF58476D1CE4E5B9ull;
+    return (size_t)(h >> 32);
+}
+
+} // namespace
+
+FlowKey FlowTable::Entry::key() const {
+    FlowKey k;
+    k.src = (uint32_t)(addrs >> 32);
+    k.dst = (uint32_t)addrs;
+    k.proto = (uint8_t)(rest >> 32);
+    k.srcPort = (uint16_t)(rest >> 16);
+    k.dstPort = (uint16_t)rest;
+    return k;
+}
+
+FlowTable::FlowTable() : slots(1024, Entry{ 0, EMPTY, 0 }) {
+}
+
+void FlowTable::insert(uint64_t addrs, uint64_t rest, uint64_t n) {
+    const size_t mask = slots.size() - 1;
+    for (size_t i = hashFlow(addrs, rest) & mask;; i = (i + 1) & mask) {
+        Entry& e = slots[i];
+        if (e.rest == rest && e.addrs == addrs) {
+            e.count += n;
+            return;
+        }
+        if (e.rest == EMPTY) {
+            e.addrs = addrs;
+            e.rest = rest;
+            e.count = n;
+            // װʳһʱݣ̽ж
+            if (++used * 2 > slots.size()) {
+                grow();
+            }
+            return;
+        }
+    }
+}
+
+void FlowTable::grow() {
+    vector<Entry> old(slots.size() * 2, Entry{ 0, EMPTY, 0 });
+    old.swap(slots);
+    used = 0;
+    for (const Entry& e : old) {
+        if (e.rest != EMPTY) insert(e.addrs, e.rest, e.count);
+    }
+}
+
+void FlowTable::clear() {
+    fill(slots.begin(), slots.end(), Entry{ 0, EMPTY, 0 });
+    used = 0;
+}
+
+void FlowTable::merge(const FlowTable& other) {
+    for (const Entry& e : other.slots) {
+        if (e.rest != EMPTY) insert(e.addrs, e.rest, e.count);
+    }
+}
+
+vector<FlowTable::Entry> FlowTable::sorted() const {
+    vector<Entry> all;
+    all.reserve(used);
+    for (const Entry& e : slots) {
+        if (e.rest != EMPTY) all.push_back(e);
+    }
+    sort(all.begin(), all.end(), [](const Entry& a, const Entry& b) {
+        return a.addrs != b.addrs ? a.addrs < b.addrs : a.rest < b.rest;
+    });
+    return all;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ------------------ ͳ ------------------
+
+/**
+ * @brief ıʶԴIPĿIPЭţԼѡ TCP/UDP ˿ڣֶ˿ʱΪ 0
+ */
+struct FlowKey {
+    uint32_t src = 0;     // ֽ
+    uint32_t dst = 0;
+    uint16_t srcPort = 0;
+    uint16_t dstPort = 0;
+    uint8_t proto = 0;
+};
+
+/**
+ * @brief ĿѰַϣ̽⣩
+ *
+ *  64 λ棬Ƚɢжֻ㣻ÿݰļκθʽ
+ * Ҳڴ棨ݳ⣩ַЭֻʾʱ key() ȡٸʽ
+ * ̰߳ȫġ
+ */
+class FlowTable {
+public:
+    struct Entry {
+        uint64_t addrs; // Դַڸ 32 λĿĵַڵ 32 λ
+        uint64_t rest;  // Э (39..32)Դ˿ (31..16)ĿĶ˿ (15..0)
+        uint64_t count; // ݰ
+
+        FlowKey key() const;
+    };
+
+    FlowTable();
+
+    /**
+     * @brief Ӧļ n
+     */
+    void add(const FlowKey& key, uint64_t n = 1) {
+        insert(((uint64_t)key.src << 32) | key.dst,
+               ((uint64_t)key.proto << 32) | ((uint64_t)key.srcPort << 16) | key.dstPort, n);
+    }
+
+    /**
+     * @brief мѷĲ
+     */
+    void clear();
+
+    /**
+     * @brief һűļϲ
+     */
+    void merge(const FlowTable& other);
+
+    /**
+     * @brief ȫԴIPĿIPЭ顢˿
+     */
+    std::vector<Entry> sorted() const;
+
+    size_t size() const {
+        return used;
+    }
+
+private:
+    static const uint64_t EMPTY = ~(uint64_t)0; // ղ۱ǣrest ȡֵ
+
+    void insert(uint64_t addrs, uint64_t rest, uint64_t n);
+    void grow();
+
+    std::vector<Entry> slots; // Ϊ2
+    size_t used = 0;
+};
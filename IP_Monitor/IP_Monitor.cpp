@@ -11,11 +11,17 @@
 #include <mstcpip.h>      //  SIO_RCVALL  IOCTL Ķ
 #include <iostream>       // ׼
 #include <iomanip>        // ڸʽ setw
-#include <map>            // ڴ洢ͳ
 #include <vector>         // ڴ洢б
 #include <string>         // C++ ַ
 #include <thread>         // C++11 ֧֣߳ʵʱʾ
 #include <chrono>         // C++11 ʱ⣬ڼʱ
+#include <atomic>         // ֪ͨʾ߳˳
+#include <memory>         // unique_ptr
+
+#include "../Common/TextBuffer.h" // ɸõıʱظʽ
+#include "../Common/ProtocolViews.h" // 㿽Эײͼ
+#include "FlowTable.h"              // ԴΪ
+#include "TripleBuffer.h"           // ץ߳ʾ̷߳ͳƿ
 
 // -------------------------------
 // ӿ
@@ -33,42 +39,129 @@ const std::string WarningMsg = "\033[33m[WARN]\033[0m\t";    // 
 
 using namespace std;
 
+const chrono::milliseconds PUBLISH_INTERVAL(100); // ץ̷߳ͳƿյļ
+const DWORD RECV_TIMEOUT_MS = 100;                // ûݰʱҲҪʱաʱ
+
 // -------------------------------
 // ݽṹ
 // -------------------------------
 
 /**
- * @brief Ϊ map ļͳƲͬ
- *        һԴIPĿIPЭΨһȷ
+ * @brief һͳƣַЭֻʾʱʽ
+ * @param out 
+ * @param e 
+ * @param withPorts Ƿʾ˿
+ */
+void appendFlow(TextBuffer& out, const FlowTable::Entry& e, bool withPorts) {
+    const FlowKey k = e.key();
+    //  start ʼһ뵽 width ַݹʱһո
+    auto column = [&out](size_t start, size_t width) {
+        const size_t used = out.size() - start;
+        out.fill(' ', used < width ? width - used : 1);
+    };
+    size_t start = out.size();
+    out.ipv4(k.src);
+    column(start, 18);
+    start = out.size();
+    out.ipv4(k.dst);
+    column(start, 18);
+    start = out.size();
+    const char* name = ipProtocolName(k.proto);
+    if (name) out.put(name);
+    else out.dec(k.proto); // δʶЭʾЭ
+    column(start, 10);
+    if (withPorts) {
+        start = out.size();
+        if (k.proto == IP_PROTO_TCP || k.proto == IP_PROTO_UDP) {
+            out.dec(k.srcPort).put(" -> ").dec(k.dstPort);
+        }
+        column(start, 16);
+    }
+    out.dec(e.count).put('\n');
+}
+
+/**
+ * @brief һץ̵߳ͳƷƬcounts ֻɸ̸߳£
+ *        ÿڰ counts ݸƵзʾֻ߳ȡĿ
  */
-struct Key {
-    string src;   // ԴIPַ
-    string dst;   // ĿIPַ
-    string proto; // Э
-
-    /**
-     * @brief Сʹ Key ṹԱ std::map ļ
-     * @param other һ Key 
-     * @return ǰС other򷵻 true
-     */
-    bool operator<(const Key& other) const {
-        return std::tie(src, dst, proto) < std::tie(other.src, other.dst, other.proto);
+struct CaptureShard {
+    FlowTable counts;
+    TripleBuffer<FlowTable> snapshots;
+
+    void publish() {
+        snapshots.back() = counts; // ûеʱڴ
+        snapshots.publish();
     }
 };
 
 /**
- * @brief IPͷеЭתΪɶַơ
- * @param proto IPݰͷеЭֵֶ (1 byte)
- * @return ӦЭַ
+ * @brief ץ̣߳ݰۼӵԼķƬڷգ endTime 
+ * @param s ԭʼ׽֣ץ̹߳
+ * @param localAddr ַֽ򣩣ֻͳ뱾صݰ
+ * @param withPorts Ƿ TCP/UDP ˿
+ * @param endTime ʱ
+ * @param shard ̵߳ͳƷƬ
  */
-string protocolName(unsigned char proto) {
-    switch (proto) {
-    case 1: return "ICMP";
-    case 2: return "IGMP";
-    case 6: return "TCP";
-    case 17: return "UDP";
-    default: return "Other"; // δʶЭ
+void captureLoop(SOCKET s, uint32_t localAddr, bool withPorts, chrono::steady_clock::time_point endTime, CaptureShard& shard) {
+    unsigned char buffer[65536]; // һ㹻Ļݰ
+    auto nextPublish = chrono::steady_clock::now() + PUBLISH_INTERVAL;
+
+    for (;;) {
+        const auto now = chrono::steady_clock::now();
+        if (now >= endTime)
+            break;
+        if (now >= nextPublish) {
+            shard.publish(); // ֻһθһԭӽȴʾ߳
+            nextPublish = now + PUBLISH_INTERVAL;
+        }
+
+        // ׽ֽݣȴ RECV_TIMEOUT_MS
+        int ret = recv(s, (char*)buffer, sizeof(buffer), 0);
+        if (ret <= 0) continue; // ճʱʧܻûݣһѭ
+
+        // ---- IPͷ ----
+        // յ buffer ֱӾ IP ͷʼݣһײݰֱӶ
+        const Ipv4View ip(buffer, (size_t)ret);
+        if (!ip.valid())
+            continue;
+
+        // ļֱȡײеκθʽ
+        FlowKey k;
+        k.src = ip.srcAddr();
+        k.dst = ip.dstAddr();
+        k.proto = ip.protocol();
+
+        // ---- ݰ ----
+        // ˵㲥
+        if (k.dst == 0xFFFFFFFF)
+            continue;
+
+        // ֻͳ뱾IPصݰΪԴĿģ
+        if (k.src != localAddr && k.dst != localAddr)
+            continue;
+
+        // ƬƬûϲײ˿ڼΪ 0
+        if (withPorts && !ip.laterFragment()) {
+            if (k.proto == IP_PROTO_TCP) {
+                const TcpView tcp(ip.payload(), ip.payloadLen());
+                if (tcp.valid()) {
+                    k.srcPort = tcp.srcPort();
+                    k.dstPort = tcp.dstPort();
+                }
+            }
+            else if (k.proto == IP_PROTO_UDP) {
+                const UdpView udp(ip.payload(), ip.payloadLen());
+                if (udp.valid()) {
+                    k.srcPort = udp.srcPort();
+                    k.dstPort = udp.dstPort();
+                }
+            }
+        }
+
+        // ---- ͳϢ ----
+        shard.counts.add(k); // ¶Ӧļ
     }
+    shard.publish(); // ս
 }
 
 // -------------------------------
@@ -77,8 +170,17 @@ string protocolName(unsigned char proto) {
 int main(int argc, char* argv[])
 {
     // --- 1.  ---
-    if (argc != 2) {
-        cout << ErrorMsg << "÷: IP_Monitor.exe <ץʱ()>\n";
+    // ѡ --ports  TCP/UDP ˿ڽһ-j N  N ߳ͬʱ
+    bool withPorts = false;
+    int captureThreads = 1;
+    bool argsOk = argc >= 2;
+    for (int i = 2; i < argc && argsOk; ++i) {
+        if (strcmp(argv[i], "--ports") == 0) withPorts = true;
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) captureThreads = atoi(argv[++i]);
+        else argsOk = false;
+    }
+    if (!argsOk || captureThreads <= 0) {
+        cout << ErrorMsg << "÷: IP_Monitor.exe <ץʱ()> [--ports] [-j ץ߳]\n";
         return -1;
     }
 
@@ -165,6 +267,7 @@ int main(int argc, char* argv[])
     localAddr.sin_family = AF_INET;
     inet_pton(AF_INET, localIP.c_str(), &localAddr.sin_addr);
     localAddr.sin_port = 0; // ˿ںŶԭʼ׽
+    const uint32_t localAddr32 = ntohl(localAddr.sin_addr.s_addr); // ײеĵֱַӱȽ
 
     if (bind(s, (sockaddr*)&localAddr, sizeof(localAddr)) == SOCKET_ERROR) {
         cout << ErrorMsg << "bind ʧܣҪԹԱȨУ: " << WSAGetLastError() << "\n";
@@ -184,87 +287,84 @@ int main(int argc, char* argv[])
         return -1;
     }
 
+    // ճʱûݰʱץ߳Ҳܰʱաʱ
+    DWORD recvTimeout = RECV_TIMEOUT_MS;
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, (const char*)&recvTimeout, sizeof(recvTimeout));
+
     // --- 6. ׼ͳ߳ʾ ---
-    map<Key, int> statistics; // ڴ洢ݰͳƽ
-    bool running = true; // ʾ̵߳ѭ
+    // ÿץ߳һͳƷƬԸ¡ʾֻ߳ȡƬĿ
+    vector<unique_ptr<CaptureShard>> shards;
+    for (int i = 0; i < captureThreads; ++i) {
+        shards.emplace_back(new CaptureShard());
+    }
+    atomic<bool> running{ true }; // ʾ̵߳ѭ
 
     auto startTime = chrono::steady_clock::now(); // ¼ץʼʱ
     auto endTime = startTime + chrono::seconds(captureSeconds); // ץʱ
 
-    // һ̣߳ʵʱˢºʾͳ
-    thread displayThread([&]() {
-        while (running) {
-            system("cls"); // տ̨Ļ
-
-            // ӡ͵ǰ״̬
-            cout << InformationMsg << "\033[33mǰѡϢ\033[0m" << AdapterInfo << "\033[33m IP: \033[0m" << localIP << endl;
-            auto elapsed = chrono::duration_cast<chrono::seconds>(chrono::steady_clock::now() - startTime).count() + 1;
-            if (elapsed > captureSeconds) {
-                cout << InformationMsg << "ʼץ " << captureSeconds << "/" << captureSeconds << " ...\n";
-            }
-            else {
-                cout << InformationMsg << "ʼץ " << elapsed << "/" << captureSeconds << " ...\n";
-            }
-            cout << InformationMsg << "ʵʱ IP ݰͳƣÿˢ£\n";
-            cout << "\033[32m-----------------------------------------------------------\033[0m\n";
-            cout << "\033[33m" << left << setw(18) << "ԴIP"
-                << setw(18) << "ĿIP"
-                << setw(10) << "Э"
-                << setw(8) << "" << "\033[0m" << endl;
-            cout << "\033[32m-----------------------------------------------------------\033[0m\n";
-
-            //  map ӡͳ
-            for (auto& kv : statistics) {
-                cout << left << setw(18) << kv.first.src
-                    << setw(18) << kv.first.dst
-                    << setw(10) << kv.first.proto
-                    << setw(8) << kv.second << endl;
-            }
+    // ϲƬĿղʾֻһ̵߳
+    FlowTable merged;
+    auto render = [&]() {
+        system("cls"); // տ̨Ļ
 
-            cout << "\033[32m-----------------------------------------------------------\033[0m\n";
-            this_thread::sleep_for(chrono::seconds(1)); // ÿˢһ
+        // ӡ͵ǰ״̬
+        cout << InformationMsg << "\033[33mǰѡϢ\033[0m" << AdapterInfo << "\033[33m IP: \033[0m" << localIP << endl;
+        auto elapsed = chrono::duration_cast<chrono::seconds>(chrono::steady_clock::now() - startTime).count() + 1;
+        if (elapsed > captureSeconds) {
+            cout << InformationMsg << "ʼץ " << captureSeconds << "/" << captureSeconds << " ...\n";
+        }
+        else {
+            cout << InformationMsg << "ʼץ " << elapsed << "/" << captureSeconds << " ...\n";
+        }
+        cout << InformationMsg << "ʵʱ IP ݰͳƣÿˢ£\n";
+        cout << "\033[32m-----------------------------------------------------------\033[0m\n";
+        cout << "\033[33m" << left << setw(18) << "ԴIP"
+            << setw(18) << "ĿIP"
+            << setw(10) << "Э";
+        if (withPorts) cout << setw(16) << "˿";
+        cout << setw(8) << "" << "\033[0m" << endl;
+        cout << "\033[32m-----------------------------------------------------------\033[0m\n";
+
+        // һ update() ֮ǰı䣬ϲڼץ߳ճԼķƬ
+        merged.clear();
+        for (auto& shard : shards) {
+            shard->snapshots.update();
+            merged.merge(shard->snapshots.front());
         }
-        });
-
-    // --- 7. ѭץ ---
-    unsigned char buffer[65536]; // һ㹻Ļݰ
-
-    while (chrono::steady_clock::now() < endTime) {
-        // ׽ֽݣrecvֱݵ
-        int ret = recv(s, (char*)buffer, sizeof(buffer), 0);
-        if (ret <= 0) continue; // ʧܻûݣһѭ
-
-        // ---- IPͷ ----
-        // յ buffer ֱӾ IP ͷʼ
-        unsigned char* ip = buffer;
-
-        // IPͷ10ֽ(ƫΪ9)Эֶ
-        unsigned char proto = ip[9];
 
-        // ԴĿIPַ
-        // ԴIPַƫ 12-15 ֽ
-        // ĿIPַƫ 16-19 ֽ
-        char srcIP[16], dstIP[16];
-        sprintf(srcIP, "%d.%d.%d.%d", ip[12], ip[13], ip[14], ip[15]);
-        sprintf(dstIP, "%d.%d.%d.%d", ip[16], ip[17], ip[18], ip[19]);
+        // ַиʽȰűƴһд
+        TextBuffer& table = threadTextBuffer();
+        table.clear();
+        for (const FlowTable::Entry& e : merged.sorted()) {
+            appendFlow(table, e, withPorts);
+        }
+        cout.write(table.data(), (streamsize)table.size());
 
-        // ---- ݰ ----
-        // ˵㲥
-        if (strcmp(dstIP, "255.255.255.255") == 0)
-            continue;
+        cout << "\033[32m-----------------------------------------------------------\033[0m\n";
+    };
 
-        // ֻͳ뱾IPصݰΪԴĿģ
-        if (localIP != srcIP && localIP != dstIP)
-            continue;
+    // һ̣߳ʵʱˢºʾͳ
+    thread displayThread([&]() {
+        while (running.load()) {
+            render();
+            this_thread::sleep_for(chrono::seconds(1)); // ÿˢһ
+        }
+        });
 
-        // ---- ͳϢ ----
-        Key k{ srcIP, dstIP, protocolName(proto) }; // һKey
-        statistics[k]++; // ¶Ӧļ
+    // --- 7. ץ߳ captureThreads - 1 ̴߳ͬһ׽ֽ ---
+    vector<thread> capturers;
+    for (int i = 1; i < captureThreads; ++i) {
+        capturers.emplace_back(captureLoop, s, localAddr32, withPorts, endTime, ref(*shards[i]));
+    }
+    captureLoop(s, localAddr32, withPorts, endTime, *shards[0]);
+    for (thread& t : capturers) {
+        t.join();
     }
 
     // --- 8.  ---
     running = false; // ֪ͨʾ߳˳ѭ
     displayThread.join(); // ȴʾִ߳
+    render(); // ʾ߳˳ɱ߳ʾץ߳󷢲Ľ
 
     // ر׽ֲ Winsock 
     closesocket(s);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+
+// ------------------ շ ------------------
+
+/**
+ * @brief дߡߵ壺дݷȡһ
+ *
+ * ֱдߡߺмλóУֻһԭӲ˫ȴԷ
+ * д back() дһݺ publish()мλý update() ʱ·һݣ
+ * Ͱмλû front()õддõһݣһ update() ֮ǰı䡣
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    /**
+     * @brief ддĻֻд߷
+     */
+    T& back() {
+        return buffers[backIndex];
+    }
+
+    /**
+     * @brief д߷ back()֮ back() һǽһ
+     */
+    void publish() {
+        backIndex = state.exchange(backIndex | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    /**
+     * @brief ߻һ
+     * @return ϴεû·ʱ falsefront() 
+     */
+    bool update() {
+        if ((state.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        frontIndex = state.exchange(frontIndex, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    /**
+     * @brief ߳еһݣֻɶ߷
+     */
+    const T& front() const {
+        return buffers[frontIndex];
+    }
+
+private:
+    static const unsigned INDEX = 3;  // мλõĻ
+    static const unsigned FRESH = 4;  // мλǶδȡߵ·
+
+    T buffers[3];
+    std::atomic<unsigned> state{ 1 }; // мλ
+    unsigned backIndex = 0;
+    unsigned frontIndex = 2;
+};
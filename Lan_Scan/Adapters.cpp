@@ -0,0 +1,136 @@
+// ĳЩµ Visual Studio 汾УһЩͳ Winsock Ϊá˺Խùʹþɰ Winsock ľ档
+#define _WINSOCK_DEPRECATED_NO_WARNINGS
+// ʹ fopen ȴͳ CRT 
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "Adapters.h"
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <iphlpapi.h>
+#pragma comment(lib, "iphlpapi.lib")
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+bool listAdapters(vector<Adapter>& adapters, string& error) {
+    adapters.clear();
+    ULONG outBufLen = 0;
+    // һε GetAdaptersInfo nullptrԻȡĻС
+    DWORD dwRet = GetAdaptersInfo(nullptr, &outBufLen);
+    if (dwRet != ERROR_BUFFER_OVERFLOW) {
+        error = "GetAdaptersInfo failed to get buffer size: " + to_string(dwRet);
+        return false;
+    }
+    vector<BYTE> buffer(outBufLen);
+    PIP_ADAPTER_INFO pAdapterInfo = reinterpret_cast<PIP_ADAPTER_INFO>(buffer.data());
+    dwRet = GetAdaptersInfo(pAdapterInfo, &outBufLen);
+    if (dwRet != NO_ERROR) {
+        error = "GetAdaptersInfo failed: " + to_string(dwRet);
+        return false;
+    }
+
+    for (PIP_ADAPTER_INFO pAdapter = pAdapterInfo; pAdapter != nullptr; pAdapter = pAdapter->Next) {
+        Adapter a;
+        a.name = pAdapter->AdapterName;
+        a.description = pAdapter->Description;
+        a.macLen = pAdapter->AddressLength < sizeof(a.mac) ? pAdapter->AddressLength : sizeof(a.mac);
+        memcpy(a.mac, pAdapter->Address, a.macLen);
+        a.gateway = ntohl(inet_addr(pAdapter->GatewayList.IpAddress.String));
+        if (a.gateway == 0xFFFFFFFF) a.gateway = 0;
+        for (IP_ADDR_STRING* ipAddr = &pAdapter->IpAddressList; ipAddr != nullptr; ipAddr = ipAddr->Next) {
+            if (ipAddr->IpAddress.String[0] == '\0') break; //  IP ַַΪգֹͣ
+            // ʮַתΪֽתΪֽ
+            const uint32_t ip = ntohl(inet_addr(ipAddr->IpAddress.String));
+            const uint32_t mask = ntohl(inet_addr(ipAddr->IpMask.String));
+            a.addresses.push_back(AdapterAddress{ ip, mask });
+        }
+        adapters.push_back(a);
+    }
+    return true;
+}
+
+#else
+
+namespace {
+
+/**
+ * @brief  /proc/net/route ӿڵĬ
+ */
+uint32_t defaultGateway(const string& ifname) {
+    FILE* fp = fopen("/proc/net/route", "r");
+    if (!fp) {
+        return 0;
+    }
+    char line[256];
+    uint32_t gateway = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        char name[64];
+        unsigned int dest = 0, gw = 0;
+        // Ϊ Iface Destination Gateway ...ַΪֽʮ
+        if (sscanf(line, "%63s %x %x", name, &dest, &gw) == 3 && dest == 0 && ifname == name) {
+            gateway = ntohl(gw);
+            break;
+        }
+    }
+    fclose(fp);
+    return gateway;
+}
+
+Adapter& adapterNamed(vector<Adapter>& adapters, const char* name) {
+    for (Adapter& a : adapters) {
+        if (a.name == name) return a;
+    }
+    Adapter a;
+    a.name = name;
+    a.description = name;
+    a.macLen = 0;
+    a.gateway = defaultGateway(a.name);
+    adapters.push_back(a);
+    return adapters.back();
+}
+
+} // namespace
+
+bool listAdapters(vector<Adapter>& adapters, string& error) {
+    adapters.clear();
+    struct ifaddrs* list = nullptr;
+    if (getifaddrs(&list) != 0) {
+        error = "getifaddrs failed";
+        return false;
+    }
+    // ͬһӿڵӲַ (AF_PACKET)  IPv4 ַ (AF_INET) ֱ֣ӿϲ
+    for (struct ifaddrs* ifa = list; ifa != nullptr; ifa = ifa->ifa_next) {
+        if (!ifa->ifa_addr || (ifa->ifa_flags & IFF_LOOPBACK) || !(ifa->ifa_flags & IFF_UP)) {
+            continue;
+        }
+        if (ifa->ifa_addr->sa_family == AF_PACKET) {
+            const struct sockaddr_ll* ll = (const struct sockaddr_ll*)ifa->ifa_addr;
+            Adapter& a = adapterNamed(adapters, ifa->ifa_name);
+            a.macLen = ll->sll_halen < sizeof(a.mac) ? ll->sll_halen : sizeof(a.mac);
+            memcpy(a.mac, ll->sll_addr, a.macLen);
+        }
+        else if (ifa->ifa_addr->sa_family == AF_INET && ifa->ifa_netmask) {
+            Adapter& a = adapterNamed(adapters, ifa->ifa_name);
+            const uint32_t ip = ntohl(((const struct sockaddr_in*)ifa->ifa_addr)->sin_addr.s_addr);
+            const uint32_t mask = ntohl(((const struct sockaddr_in*)ifa->ifa_netmask)->sin_addr.s_addr);
+            a.addresses.push_back(AdapterAddress{ ip, mask });
+        }
+    }
+    freeifaddrs(list);
+    return true;
+}
+
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ------------------  ------------------
+
+/**
+ * @brief ϵһ IPv4 ַֽ
+ */
+struct AdapterAddress {
+    uint32_t ip;
+    uint32_t mask;
+};
+
+/**
+ * @brief Ϣ
+ */
+struct Adapter {
+    std::string name;        // Windows Ϊ GUIDLinux Ϊӿ eth0ҲǴԭʼ׽ʱʹõ
+    std::string description; // Linux  name ͬ
+    uint8_t mac[8];          // Ӳַ
+    size_t macLen;           // Ӳַȣ0 ʾû
+    uint32_t gateway;        // Ĭأֽ򣩣0 ʾû
+    std::vector<AdapterAddress> addresses;
+};
+
+/**
+ * @brief гWindows ʹ GetAdaptersInfoLinux ʹ getifaddrsػӿδõĽӿڣ
+ * @param adapters б
+ * @param error ʧʱԭ
+ * @return ʧܷ false
+ */
+bool listAdapters(std::vector<Adapter>& adapters, std::string& error);
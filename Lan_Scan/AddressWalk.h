@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+
+// ------------------ ɨ˳ ------------------
+
+/**
+ * @brief Դҵ˳ [first, first + count) ڵĵַԤб
+ *
+ *  i ַΪ first + (offset + i * step) mod countstep  count أ
+ *  i ȡ [0, count) ʱÿַǡóһΡstep ȡ count Ļƽָ㸽
+ * ̽ԶλãطɢͬĽ˿ϣ
+ * offset  step ѡȡÿɨ˳ͬ
+ * ±궼ֱӦַ̹߳һɸȡһΡ
+ */
+class AddressWalk {
+public:
+    /**
+     * @param first һַֽ
+     * @param count ַ 2^32
+     * @param seed 
+     */
+    AddressWalk(uint32_t first, uint64_t count, uint64_t seed)
+        : first(first), count(count) {
+        if (count <= 1) {
+            return;
+        }
+        seed = mix(seed);
+        offset = seed % count;
+        // ӻƽָ㸽λÿʼҵһ count صĲ
+        const uint64_t golden = (uint64_t)((double)count * 0.6180339887);
+        const uint64_t jitter = count / 64 + 1;
+        step = (golden + (mix(seed) % jitter)) % count;
+        if (step == 0) step = 1;
+        while (gcd(step, count) != 1) {
+            step = step + 1 < count ? step + 1 : 1;
+        }
+    }
+
+    uint64_t size() const {
+        return count;
+    }
+
+    /**
+     * @brief  i ̽Ŀ first ƫƣi < size()
+     */
+    uint64_t offsetAt(uint64_t i) const {
+        // i  step С 2^32˻
+        return (offset + (i % count) * step) % count;
+    }
+
+    /**
+     * @brief  i ̽Ŀַi < size()
+     */
+    uint32_t at(uint64_t i) const {
+        return first + (uint32_t)offsetAt(i);
+    }
+
+private:
+    static uint64_t gcd(uint64_t a, uint64_t b) {
+        while (b != 0) {
+            const uint64_t t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
+
+    // splitmix64 ĻϺӴɢ
+    static uint64_t mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    uint32_t first;
+    uint64_t count;
+    uint64_t offset = 0;
+    uint64_t step = 1;
+};
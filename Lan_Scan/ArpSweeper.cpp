@@ -0,0 +1,322 @@
+#include "ArpSweeper.h"
+#include "../Ethernet_ARP/ArpPacket.h"
+#include "../Ethernet_ARP/ArpTracker.h"
+#include "../Ethernet_ARP/RawLink.h"
+#include "AddressWalk.h"
+#include "RateLimiter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <random>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+const size_t SEND_BATCH = 256;      // ÿϵͳ෢
+const size_t MAX_IN_FLIGHT = 65536; // ÿӿͬʱȴӦƶʱеĳ
+const size_t MAX_SKIP = 65536;      // ÿĵַ˵󲿷ֵַʱҲܼʱط
+
+/**
+ * @brief ʱеһʱĿδӦط
+ */
+struct RetryTimer {
+    uint64_t deadline; // ʱ䣨룩
+    size_t job;        // 
+    uint64_t index;    // Ŀһַƫ
+    unsigned int attempt; // ѷ͵Ĵ
+};
+
+/**
+ * @brief Ҫ͵һ
+ */
+struct Pending {
+    size_t job;
+    uint64_t index;
+    unsigned int attempt;
+};
+
+} // namespace
+
+struct ArpSweeper::Interface {
+    RawLink link;
+    TokenBucket bucket;
+    deque<RetryTimer> timers;
+    vector<size_t> jobs;  // ýӿϵ
+    size_t cursor = 0;    // һִĸȡĿ
+};
+
+struct ArpSweeper::Job {
+    Job(size_t iface, uint32_t srcIp, uint32_t first, uint64_t count, const TargetFilter& accept, uint64_t seed)
+        : iface(iface), srcIp(srcIp), first(first), count(count), accept(accept), walk(first, count, seed),
+          words((size_t)((count + 63) / 64)), answered(new atomic<uint64_t>[words]) {
+        for (size_t i = 0; i < words; ++i) {
+            answered[i].store(0, memory_order_relaxed);
+        }
+    }
+
+    bool isAnswered(uint64_t index) const {
+        return (answered[index / 64].load(memory_order_acquire) >> (index % 64)) & 1;
+    }
+
+    /**
+     * @brief λӦ־
+     * @return ĿǰδӦʱ true
+     */
+    bool markAnswered(uint64_t index) {
+        const uint64_t bit = 1ull << (index % 64);
+        return (answered[index / 64].fetch_or(bit, memory_order_acq_rel) & bit) == 0;
+    }
+
+    bool exhausted() const {
+        return next >= count;
+    }
+
+    size_t iface;
+    uint32_t srcIp;
+    uint32_t first;
+    uint64_t count;
+    TargetFilter accept;
+    AddressWalk walk;
+    size_t words;
+    unique_ptr<atomic<uint64_t>[]> answered; // ÿĿһλɽ߳λ߳طǰ
+    uint64_t next = 0;      // һĿڱ˳е
+    atomic<uint64_t> walked{ 0 }; // next ĸ̶߳ȡ
+    uint64_t inFlight = 0;  // ִ붨ʱڸ
+    bool done = false;
+    atomic<uint64_t> found{ 0 };
+    uint64_t heard = 0;     // 
+    SweepStats stats;
+};
+
+ArpSweeper::ArpSweeper() = default;
+
+ArpSweeper::~ArpSweeper() = default;
+
+int ArpSweeper::addInterface(const char* ifname, unsigned int pps) {
+    unique_ptr<Interface> i(new Interface());
+    if (!i->link.open(ifname)) {
+        err = i->link.error();
+        return -1;
+    }
+    //  10ms ƣһ
+    i->bucket = TokenBucket(pps, min((double)SEND_BATCH, pps / 100.0));
+    interfaces.push_back(move(i));
+    return (int)interfaces.size() - 1;
+}
+
+size_t ArpSweeper::addJob(int iface, uint32_t srcIp, uint32_t first, uint64_t count, const TargetFilter& accept) {
+    random_device rd;
+    const uint64_t seed = ((uint64_t)rd() << 32) ^ rd() ^ TokenBucket::nowNs();
+    jobs.emplace_back(new Job((size_t)iface, srcIp, first, count, accept, seed));
+    interfaces[(size_t)iface]->jobs.push_back(jobs.size() - 1);
+    return jobs.size() - 1;
+}
+
+const SweepStats& ArpSweeper::stats(size_t job) const {
+    return jobs[job]->stats;
+}
+
+void ArpSweeper::progress(uint64_t& walked, uint64_t& answered) const {
+    walked = 0;
+    answered = 0;
+    for (const auto& job : jobs) {
+        walked += job->walked.load(memory_order_relaxed);
+        answered += job->found.load(memory_order_relaxed);
+    }
+}
+
+void ArpSweeper::run(const SweepOptions& options, const HostCallback& onHost, const MissCallback& onMiss) {
+    if (jobs.empty()) {
+        return;
+    }
+    atomic<bool> stop{ false };
+
+    // --- ̣߳нӿϵȴӦ ---
+    thread receiver([&]() {
+        vector<RawLink*> links;
+        for (auto& i : interfaces) links.push_back(&i->link);
+        vector<RxFrame> frames;
+        while (!stop.load(memory_order_acquire)) {
+            RawLink::waitAny(links.data(), links.size(), 20);
+            for (auto& iface : interfaces) {
+                // һȡýӿоĿ飬 RX 
+                while (iface->link.receive(frames, 0) > 0) {
+                    for (const RxFrame& f : frames) {
+                        ArpMessage msg;
+                        if (parse_arp(f.data, f.len, msg) != ArpParseResult::Ok || msg.opcode != ARP_OP_REPLY) {
+                            continue;
+                        }
+                        for (size_t j : iface->jobs) {
+                            Job& job = *jobs[j];
+                            const uint64_t index = (uint64_t)(uint32_t)(msg.sender_ip - job.first);
+                            if (msg.target_ip != job.srcIp || index >= job.count) {
+                                continue; // ǷӦ𣬻ɨ跶Χ
+                            }
+                            if (job.markAnswered(index)) {
+                                job.found.fetch_add(1, memory_order_relaxed);
+                                onHost(j, msg.sender_ip, msg.sender_mac);
+                            }
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    // --- ̣ͣ߳ӿÿӿÿһ ---
+    const uint64_t timeoutNs = (uint64_t)options.timeoutMs * 1000000;
+    const uint64_t start = TokenBucket::nowNs();
+    ArpBatch batch(SEND_BATCH);
+    Pending pending[SEND_BATCH];
+    uint32_t targets[SEND_BATCH];
+    size_t remaining = jobs.size();
+
+    // ĿѷꡢʱҲûʱ
+    auto finishIfDone = [&](Job& job, uint64_t now) {
+        if (!job.done && job.exhausted() && job.inFlight == 0) {
+            job.done = true;
+            job.stats.seconds += (double)(now - start) / 1e9; // ֮ǰ listen() ʱҲ
+            --remaining;
+        }
+    };
+    for (auto& job : jobs) {
+        finishIfDone(*job, start);
+    }
+
+    while (remaining > 0) {
+        uint64_t now = TokenBucket::nowNs();
+        uint64_t wake = now + 1000000; // ¿ʱ˯ 1ms
+        bool progressed = false;
+
+        for (auto& ifacePtr : interfaces) {
+            Interface& iface = *ifacePtr;
+            const size_t budget = iface.bucket.take(now, SEND_BATCH);
+            size_t n = 0;
+
+            // ȡڵط
+            while (n < budget && !iface.timers.empty() && iface.timers.front().deadline <= now) {
+                const RetryTimer t = iface.timers.front();
+                iface.timers.pop_front();
+                Job& job = *jobs[t.job];
+                progressed = true;
+                if (!job.isAnswered(t.index) && t.attempt <= options.retries) {
+                    pending[n++] = Pending{ t.job, t.index, t.attempt + 1 }; // Լ inFlight
+                    continue;
+                }
+                if (!job.isAnswered(t.index) && onMiss) {
+                    onMiss(t.job, job.first + (uint32_t)t.index);
+                }
+                --job.inFlight;
+                finishIfDone(job, now);
+            }
+
+            // ٴһȡĿ꣬һֻһ
+            size_t skipped = 0;
+            for (size_t k = 0; k < iface.jobs.size() && n < budget; ++k) {
+                const size_t j = iface.jobs[(iface.cursor + k) % iface.jobs.size()];
+                Job& job = *jobs[j];
+                while (n < budget && !job.exhausted() && iface.timers.size() + n < MAX_IN_FLIGHT && skipped < MAX_SKIP) {
+                    const uint64_t offset = job.walk.offsetAt(job.next++);
+                    // ѾӦĵַԼҪĵַ
+                    if (job.isAnswered(offset) || (job.accept && !job.accept(job.first + (uint32_t)offset))) {
+                        ++skipped;
+                        continue;
+                    }
+                    pending[n++] = Pending{ j, offset, 1 };
+                    ++job.inFlight;
+                    ++job.stats.probed;
+                }
+                job.walked.store(job.next, memory_order_relaxed);
+                finishIfDone(job, now); // ʣĿȫ˵ʱ
+                if (n > 0 || skipped > 0) {
+                    iface.cursor = (iface.cursor + k + 1) % iface.jobs.size();
+                    break;
+                }
+            }
+            if (skipped > 0) progressed = true;
+            iface.bucket.refund(budget - n); // ûϵһ
+
+            if (n == 0) {
+                if (!iface.timers.empty()) wake = min(wake, max(now, iface.timers.front().deadline));
+                if (budget == 0) wake = min(wake, now + iface.bucket.waitNs(now));
+                continue;
+            }
+            progressed = true;
+
+            // ͬһһι졢һη
+            for (size_t begin = 0, end = 0; begin < n; begin = end) {
+                Job& job = *jobs[pending[begin].job];
+                while (end < n && pending[end].job == pending[begin].job) {
+                    targets[end - begin] = job.first + (uint32_t)pending[end].index;
+                    ++end;
+                }
+                batch.build_requests(iface.link.mac(), job.srcIp, targets, end - begin);
+                job.stats.sent += iface.link.send(batch);
+            }
+            // ͺſʼʱһηҲУʱȷϸĿδӦ
+            const uint64_t deadline = TokenBucket::nowNs() + timeoutNs;
+            for (size_t i = 0; i < n; ++i) {
+                iface.timers.push_back(RetryTimer{ deadline, pending[i].job, pending[i].index, pending[i].attempt });
+            }
+        }
+
+        if (!progressed) {
+            now = TokenBucket::nowNs();
+            if (wake > now) this_thread::sleep_for(chrono::nanoseconds(wake - now));
+        }
+    }
+
+    stop.store(true, memory_order_release);
+    receiver.join();
+    for (auto& job : jobs) {
+        job->stats.answered = job->found.load();
+        job->stats.heard = job->heard;
+    }
+}
+
+void ArpSweeper::listen(uint64_t durationMs, const HostCallback& onHost) {
+    vector<RawLink*> links;
+    for (auto& i : interfaces) links.push_back(&i->link);
+    vector<RxFrame> frames;
+    const uint64_t start = TokenBucket::nowNs();
+    const uint64_t deadline = start + durationMs * 1000000;
+    for (;;) {
+        const uint64_t now = TokenBucket::nowNs();
+        if (now >= deadline) break;
+        RawLink::waitAny(links.data(), links.size(), (int)min<uint64_t>(100, (deadline - now) / 1000000 + 1));
+        for (auto& iface : interfaces) {
+            while (iface->link.receive(frames, 0) > 0) {
+                for (const RxFrame& f : frames) {
+                    ArpMessage msg;
+                    // ARP ̽ (RFC 5227) ķͷַΪ 0˵õַռ
+                    if (parse_arp(f.data, f.len, msg) != ArpParseResult::Ok || msg.sender_ip == 0) {
+                        continue;
+                    }
+                    for (size_t j : iface->jobs) {
+                        Job& job = *jobs[j];
+                        const uint64_t index = (uint64_t)(uint32_t)(msg.sender_ip - job.first);
+                        if (index >= job.count) {
+                            continue;
+                        }
+                        if (job.markAnswered(index)) {
+                            job.found.fetch_add(1, memory_order_relaxed);
+                            ++job.heard;
+                            onHost(j, msg.sender_ip, msg.sender_mac);
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    for (auto& job : jobs) {
+        job->stats.answered = job->found.load();
+        job->stats.heard = job->heard;
+        job->stats.seconds += (double)(TokenBucket::nowNs() - start) / 1e9;
+    }
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ------------------ 첽 ARP ɨ ------------------
+
+/**
+ * @brief ɨ
+ */
+struct SweepOptions {
+    unsigned int pps = 20000;      // ÿӿÿ෢͵0 ʾ
+    unsigned int retries = 2;      // δӦʱط
+    unsigned int timeoutMs = 300;  // ÿȴӦʱ
+};
+
+/**
+ * @brief һɨͳ
+ */
+struct SweepStats {
+    uint64_t probed = 0;   // ̽ĵַ
+    uint64_t sent = 0;     // ط
+    uint64_t answered = 0; // ֵģ
+    uint64_t heard = 0;    // б
+    double seconds = 0;    // ʱ䣬ϴӿʼɨ赽һεȴʱ
+};
+
+/**
+ * @brief ӿڡͬʱе첽 ARP ɨ
+ *
+ * ÿӿһԭʼ׽ (RawLink) һͰ٣ÿһ
+ * ͬһӿϵĶȡøýӿڵơ۽ӿж٣ʼֻ̣߳
+ *  run() ߳ΪӿڷÿһϵͳãĽ߳нӿ
+ * ȴӦĿַӦص
+ * طɸӿڵĶʱĳʱͬа˳򼴰˳У
+ * δӦĿһط
+ * Ŀ AddressWalk ҵ˳ʱɣһͬʱȴӦޣ
+ * ÿַһλӦ־⣬ڴռδС޹ء
+ * ɨǰȵ listen() һʱ䣺ڼ䲻κ
+ * ĵֱַӼΪѷ֣֮ run() ֻ̽δֵĵַ
+ */
+class ArpSweeper {
+public:
+    /**
+     * @brief ʱĻصڽ߳еãӦⵢȡӦ
+     * @param job 
+     * @param ip ַֽ
+     * @param mac  MAC ַ
+     */
+    using HostCallback = std::function<void(size_t job, uint32_t ip, const uint8_t* mac)>;
+
+    /**
+     * @brief ѡҪ̽ĵַڷ߳еã false ĵַ
+     */
+    using TargetFilter = std::function<bool(uint32_t ip)>;
+
+    /**
+     * @brief ַһطʱδӦʱĻصڷ߳е
+     */
+    using MissCallback = std::function<void(size_t job, uint32_t ip)>;
+
+    ArpSweeper();
+    ~ArpSweeper();
+    ArpSweeper(const ArpSweeper&) = delete;
+    ArpSweeper& operator=(const ArpSweeper&) = delete;
+
+    /**
+     * @brief ӿ
+     * @param ifname ӿ
+     * @param pps ýӿÿ෢͵0 ʾ
+     * @return ӿڱţʧܷ -1ԭ error()
+     */
+    int addInterface(const char* ifname, unsigned int pps);
+
+    /**
+     * @brief һɨڽӿɨ [first, first + count) Χڵĵַ
+     * @param iface addInterface() صĽӿڱ
+     * @param srcIp ڸεĵַΪķͷַֻշӦ
+     * @param first һĿַ
+     * @param count Ŀ
+     * @param accept Ϊʱ̽ⷶΧڵȫַ
+     * @return 
+     */
+    size_t addJob(int iface, uint32_t srcIp, uint32_t first, uint64_t count,
+                  const TargetFilter& accept = TargetFilter());
+
+    const std::string& error() const {
+        return err;
+    }
+
+    /**
+     * @brief ͬʱִȫ󷵻
+     * @param options ط볬ʱ addInterface() ʱָ
+     * @param onHost ʱĻصÿÿֻ̨صһ
+     * @param onMiss Ϊ
+     */
+    void run(const SweepOptions& options, const HostCallback& onHost, const MissCallback& onMiss = MissCallback());
+
+    /**
+     * @brief 󣬴ӽӿϳֵ ARP ģӦ ARP
+     *        ȡͷ IP  MACΧڵļΪѷ֣ڵִ߳
+     * @param durationMs ʱ
+     * @param onHost ÿÿ̨һʱصڵ߳е
+     */
+    void listen(uint64_t durationMs, const HostCallback& onHost);
+
+    /**
+     * @brief ͳƣrun() غЧ
+     */
+    const SweepStats& stats(size_t job) const;
+
+    /**
+     * @brief ɨȣ run() ִڼ̵߳
+     * @param walked Ѿĵַ˵ģ
+     * @param answered Ӧ
+     */
+    void progress(uint64_t& walked, uint64_t& answered) const;
+
+private:
+    struct Interface;
+    struct Job;
+
+    std::vector<std::unique_ptr<Interface>> interfaces;
+    std::vector<std::unique_ptr<Job>> jobs;
+    std::string err;
+};
@@ -1,22 +1,42 @@
 // ĳЩµ Visual Studio 汾УһЩͳ Winsock Ϊá˺Խùʹþɰ Winsock ľ档
 #define _WINSOCK_DEPRECATED_NO_WARNINGS
 
+#ifdef _WIN32
 #include <winsock2.h>     // Winsock Ĺܣ
 #include <iphlpapi.h>     // IP Helper APIڻȡϢ GetAdaptersInfo, SendARP
 #include <ws2tcpip.h>     // Winsock 2 TCP/IP ЭĸӶ
 #include <windows.h>      // Windows  APIͺͺ
+#endif
 #include <iostream>       // ڱ׼ (cout, cerr)
-#include <iomanip>        //  setfill, setw
 #include <string>         // C++ ַ (std::string)
 #include <vector>         // C++ ̬ (std::vector)
 #include <cstdint>        // ׼ͣ uint32_t
-#include <sstream>        // ַڹַ
+#include <cstring>        // memcpy
+#include <cstdlib>        // strtoul
+#include <ctime>          // ھӻеʱ
 #include <thread>         // C++11 ֧߳ (std::thread)
 #include <atomic>         // C++11 ԭӲ̰߳ȫ
 #include <mutex>          // C++11 ڱԴ
+#include <condition_variable> // ѽ߳
+#include <algorithm>      //  IP 
+#include <chrono>         // ˢ¼
+#include <functional>     // ȶȡ
+#include <map>            // ӿָ
+#include <memory>         // unique_ptr
+#include <random>         // ӣɨ˳
 
+#include "../Common/TextBuffer.h" // ɸõıʽʱʱַ
+#include "../Common/OuiTable.h"   //  OUI ̱
+#include "Adapters.h"             // ö
+#include "AddressWalk.h"          // ҵ˳ʱɨĿ
+#include "ArpSweeper.h"           // ԭʼ׽ֵ첽 ARP ɨ裨Linux
+#include "NeighborCache.h"        // ־ûھӻ棬ɨ
+#include "RateLimiter.h"          // ÿӿڵͰ
+
+#ifdef _WIN32
 #pragma comment(lib, "iphlpapi.lib") //  IP Helper API ⣬ṩ
 #pragma comment(lib, "ws2_32.lib")   //  Winsock 2.2 ⣬ṩ׽ֹ
+#endif
 
 const std::string ErrorMsg = "\033[31m[ERR]\033[0m\t";
 const std::string InformationMsg = "\033[32m[INFO]\033[0m\t";
@@ -25,87 +45,609 @@ const std::string WarningMsg = "\033[33m[WARN]\033[0m\t";
 using namespace std;
 
 /**
- * @brief ֽʽΪðŷָʮ MAC ַַ
+ * @brief ֽʽΪðŷָСдʮ MAC ַ׷ӵ
+ * @param out 
  * @param addr ָ MAC ַָֽ롣
- * @param len MAC ַĳȣֽΪλ
- * @return ʽ MAC ַַΪ 0򷵻ؿַ
+ * @param len MAC ַĳȣֽΪλΪ 0 ʱκݡ
+ * @return ʽá
+ */
+static TextBuffer& formatMac(TextBuffer& out, const uint8_t* addr, size_t len) {
+    return out.mac(addr, len, ':', false);
+}
+
+/**
+ * @brief һֵ̨׷ΪһMAC 󸽳
+ * @param out 
+ * @param tag ӿ
+ * @param ip ַֽ
+ * @param mac  MAC ַ
+ * @param macLen MAC ַ
+ * @param note βĸ˵
+ */
+static void appendHost(TextBuffer& out, const string& tag, uint32_t ip, const uint8_t* mac, size_t macLen, const char* note = "") {
+    out.put(InformationMsg).put("\033[36m[").put(tag).put("]\033[0m ").put("\033[33mIP: \033[0m").ipv4(ip);
+    out.put("\033[33m ---> \033[0m").put("\033[33mMAC: \033[0m");
+    formatMac(out, mac, macLen);
+    const char* vendor = macLen == 6 ? macVendor(mac) : nullptr;
+    if (vendor) {
+        out.put(" (").put(vendor).put(')');
+    }
+    out.put(note).put('\n');
+}
+
+/**
+ * @brief ѡ
+ */
+struct Options {
+    SweepOptions sweep;         // 첽ɨʡط볬ʱÿӿڵĬֵ
+    map<string, unsigned int> ifacePps; // ָʵĽӿ
+    string cachePath;           // ھӻļΪʱʹû
+    bool incremental = false;   // ֻ̽⻺йڵĿδַ֪
+    unsigned int ttl = 3600;    // ĿЧڣ룩
+    unsigned int samplePercent = 10; // ɨʱ̽δַ֪
+    bool progress = false;      // ɨڼڱ׼ʾ
+    unsigned int passiveSec = 0; // ɨǰ ARP 0 ʾ
+    bool noProbe = false;       // ֻκ
+};
+
+/**
+ * @brief һ̨Ӧ
+ */
+struct FoundHost {
+    uint32_t ip;
+    uint8_t mac[6];
+};
+
+/**
+ * @brief һɨɨдھӻ棬ɨڼ仺ֻ
+ */
+struct ScanResult {
+    vector<FoundHost> cached; // ɨʱδڡ̽
+    vector<FoundHost> heard;  // 
+    vector<FoundHost> hosts;  // Ӧ
+    vector<uint32_t> missed;  // ̽δӦĵַ
+};
+
+/**
+ * @brief һɨռͬʱִ
  */
-static string formatMac(const BYTE* addr, ULONG len) {
-    if (len == 0) return "";
-    ostringstream oss;
-    oss << hex << setfill('0'); // Ϊʮ '0' 
-    for (ULONG i = 0; i < len; ++i) {
-        if (i) oss << ':'; // ֽ֮ð
-        oss << setw(2) << static_cast<int>(addr[i]); // ʽÿֽΪλʮ
-    }
-    return oss.str();
+struct SubnetJob {
+    string tag;              // ӿ "eth0 192.168.1.0/24"
+    size_t adapter;          // бе±
+    uint32_t ip;             // ڸĵַ
+    uint32_t start;          // һַֽ
+    uint64_t hostCount;      // 
+    ArpSweeper::TargetFilter accept; // Ϊʱ̽ȫַ
+    bool skipped = false;    // ӿ޷򿪣ûɨ
+    ScanResult result;
+    SweepStats stats;
+};
+
+/**
+ * @brief ӿڵķʣ--pps IF=N ָȣΪ --pps N
+ */
+static unsigned int ppsFor(const Options& opt, const string& ifname) {
+    const auto it = opt.ifacePps.find(ifname);
+    return it != opt.ifacePps.end() ? it->second : opt.sweep.pps;
 }
 
+/**
+ * @brief ɨڼĽУ߳ÿ 200ms һμڱ׼ˢ£
+ *        ɨֻ߳¼κ
+ */
+class ProgressLine {
+public:
+    /**
+     * @brief ȡȣѾĵַѷ̵ֵ߳
+     */
+    using Sampler = function<void(uint64_t& walked, uint64_t& answered)>;
+
+    /**
+     * @param enabled Ϊ false ʱʲôҲ
+     * @param total ַ
+     * @param sample ȡ
+     */
+    ProgressLine(bool enabled, uint64_t total, const Sampler& sample) {
+        if (!enabled) return;
+        reporter = thread([this, total, sample]() {
+            unique_lock<mutex> lk(lock);
+            while (!done) {
+                uint64_t walked = 0, answered = 0;
+                sample(walked, answered);
+                cerr << "\r\033[K" << "ɨ " << walked << "/" << total << " ַ ("
+                     << (total ? walked * 100 / total : 100) << "%),  " << answered << " ̨" << flush;
+                wake.wait_for(lk, chrono::milliseconds(200));
+            }
+            cerr << "\r\033[K" << flush;
+        });
+    }
+
+    ~ProgressLine() {
+        if (!reporter.joinable()) return;
+        {
+            lock_guard<mutex> lk(lock);
+            done = true;
+        }
+        wake.notify_one();
+        reporter.join();
+    }
+
+private:
+    mutex lock;
+    condition_variable wake;
+    bool done = false;
+    thread reporter;
+};
+
+/**
+ * @brief в
+ * @return Ϸ trueϢ false
+ */
+static bool parseArgs(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        if (arg == "--cache" && i + 1 < argc) {
+            opt.cachePath = argv[++i];
+        }
+        else if (arg == "--incremental") {
+            opt.incremental = true;
+        }
+        else if (arg == "--progress") {
+            opt.progress = true;
+        }
+        else if (arg == "--no-probe") {
+            opt.noProbe = true;
+        }
+        else if (arg == "--pps" && i + 1 < argc && strchr(argv[i + 1], '=') != nullptr) {
+            // --pps IF=Nһӿ
+            const string value = argv[++i];
+            const size_t eq = value.rfind('=');
+            char* end = nullptr;
+            const unsigned long v = strtoul(value.c_str() + eq + 1, &end, 10);
+            if (eq == 0 || *end != '\0' || end == value.c_str() + eq + 1) {
+                cerr << ErrorMsg << "Invalid value for " << arg << ": " << value << endl;
+                return false;
+            }
+            opt.ifacePps[value.substr(0, eq)] = (unsigned int)v;
+        }
+        else if ((arg == "--pps" || arg == "--retries" || arg == "--timeout" || arg == "--ttl" || arg == "--sample" || arg == "--passive") && i + 1 < argc) {
+            char* end = nullptr;
+            const unsigned long v = strtoul(argv[++i], &end, 10);
+            if (*end != '\0' || end == argv[i]) {
+                cerr << ErrorMsg << "Invalid value for " << arg << ": " << argv[i] << endl;
+                return false;
+            }
+            if (arg == "--sample" && v > 100) {
+                cerr << ErrorMsg << "--sample Ӧ 0  100 ֮" << endl;
+                return false;
+            }
+            if (arg == "--pps") opt.sweep.pps = (unsigned int)v;
+            else if (arg == "--retries") opt.sweep.retries = (unsigned int)v;
+            else if (arg == "--timeout") opt.sweep.timeoutMs = (unsigned int)v;
+            else if (arg == "--ttl") opt.ttl = (unsigned int)v;
+            else if (arg == "--passive") opt.passiveSec = (unsigned int)v;
+            else opt.samplePercent = (unsigned int)v;
+        }
+        else {
+            cerr << ErrorMsg << "Unknown option: " << arg << endl;
+            cerr << "÷: " << argv[0] << " [--pps N] [--retries N] [--timeout MS] [--cache FILE [--incremental] [--ttl S] [--sample P]] [--passive S [--no-probe]] [--progress]" << endl;
+            cerr << "  --pps N       ÿӿÿ෢ N  ARP 0 ʾ٣Ĭ " << SweepOptions().pps << "" << endl;
+            cerr << "  --pps IF=N    ָӿ IF ʣظ" << endl;
+            cerr << "  --retries N   δӦĵַط N ΣĬ " << SweepOptions().retries << "" << endl;
+            cerr << "  --timeout MS  ÿȴӦĺĬ " << SweepOptions().timeoutMs << "" << endl;
+            cerr << "  ط볬ʱ Linux µԭʼ׽ɨ裻Windows ʹ SendARPϵͳƳʱط" << endl;
+            cerr << "  --cache FILE  дھӻ棬ϵͳھӱѽĿ" << endl;
+            cerr << "  --incremental ֻ̽⻺гЧڵĿԼδַ֪" << endl;
+            cerr << "  --ttl S       ĿЧڣ룬Ĭ " << Options().ttl << "" << endl;
+            cerr << "  --sample P    ɨʱ̽δַ֪İٷֱȣĬ " << Options().samplePercent << "" << endl;
+            cerr << "  --passive S   ȱ ARP  S 룬ֻ̽ڼûгֵĵַ Linux" << endl;
+            cerr << "  --no-probe    ֻκ" << endl;
+            cerr << "  --progress    ɨڼڱ׼ʾ" << endl;
+            return false;
+        }
+    }
+    if (opt.incremental && opt.cachePath.empty()) {
+        cerr << ErrorMsg << "--incremental Ҫͬʱָ --cache" << endl;
+        return false;
+    }
+    if (opt.noProbe && opt.passiveSec == 0) {
+        cerr << ErrorMsg << "--no-probe Ҫͬʱָ --passive" << endl;
+        return false;
+    }
+    return true;
+}
+
+#ifdef _WIN32
+
 /**
  * @brief  MAC ַǷΪȫ㡣
  * @param addr ָ MAC ַָֽ롣
  * @param len MAC ַĳȣֽΪλ
  * @return  MAC ַȫΪ㣬򷵻 true򷵻 false
  */
-static bool isZeroMac(const BYTE* addr, ULONG len) {
-    for (ULONG i = 0; i < len; ++i)
+static bool isZeroMac(const uint8_t* addr, size_t len) {
+    for (size_t i = 0; i < len; ++i)
         if (addr[i] != 0) return false; // һַֽڣ false
     return true;
 }
 
-int main() {
+/**
+ * @brief  SendARP ͬʱɨÿεӦϵͳʱһ̹߳ͬɡ
+ *        ÿ߳ӸȡַԵͰ١
+ *        д߳ԼĻɨֻ֮߳ԭӼ
+ * @param jobs ɨͳ
+ * @param adapters б
+ * @param opt ѡ
+ */
+static void scanWithSendArp(vector<SubnetJob>& jobs, const vector<Adapter>& adapters, const Options& opt) {
+    // Ҫյ ARP ĵԭʼ׽֣Windows ûУҪץ
+    if (opt.passiveSec > 0) {
+        cout << WarningMsg << "Windows ²ֱ֧" << (opt.noProbe ? "" : "ֱɨ") << endl;
+        if (opt.noProbe) return;
+    }
+    // ɨĿ갴ҵ˳±ֱԤȽַб
+    struct JobCursor {
+        JobCursor(uint32_t start, uint64_t count, uint64_t seed) : walk(start, count, seed) {
+        }
+        AddressWalk walk;
+        atomic<uint64_t> next{ 0 };      // ԭӼ̰߳ȫطַ
+        atomic<uint64_t> completed{ 0 }; // Ѵĵַ˵ģ
+        atomic<uint64_t> probed{ 0 };
+        atomic<uint64_t> answered{ 0 };
+        atomic<uint64_t> finishNs{ 0 };  // һַʱ
+    };
+    random_device rd;
+    vector<unique_ptr<JobCursor>> cursors;
+    uint64_t totalHosts = 0;
+    for (const SubnetJob& job : jobs) {
+        cursors.emplace_back(new JobCursor(job.start, job.hostCount, ((uint64_t)rd() << 32) ^ rd()));
+        totalHosts += job.hostCount;
+    }
+    // ÿһͰ
+    struct AdapterLimit {
+        mutex lock;
+        TokenBucket bucket;
+    };
+    vector<unique_ptr<AdapterLimit>> limits;
+    for (const Adapter& adapter : adapters) {
+        const unsigned int pps = ppsFor(opt, adapter.name);
+        limits.emplace_back(new AdapterLimit());
+        limits.back()->bucket = TokenBucket(pps, pps / 100.0);
+    }
+
+    // --- ߳ɨ ---
+    // ȷҪʹõ߳
+    unsigned int hc = thread::hardware_concurrency(); // ȡӲֵ֧Ĳ߳
+    if (hc == 0) hc = 4; // ޷ȡĬΪ 4
+    unsigned int maxThreads = hc;
+    if (maxThreads > 64) maxThreads = 64; // ߳Ϊ 64
+    if (maxThreads > totalHosts) maxThreads = static_cast<unsigned int>(totalHosts); // ߳ IP 
+    if (maxThreads == 0) maxThreads = 1; // ʹһ߳
+
+    cout << InformationMsg << "ʹ " << maxThreads << " ߳ͬʱɨ " << jobs.size() << " ,  " << totalHosts << " ַ..." << endl;
+
+    // ÿ߳һݽɨٺϲ
+    struct WorkerOutput {
+        vector<pair<size_t, FoundHost>> hosts; // (, )
+        vector<pair<size_t, uint32_t>> missed; // (, ַ)
+    };
+    vector<WorkerOutput> outputs(maxThreads);
+    const uint64_t startNs = TokenBucket::nowNs();
+
+    // ̺߳
+    auto worker = [&](unsigned int threadId) {
+        WorkerOutput& out = outputs[threadId];
+        size_t cursor = threadId % jobs.size(); // ̴߳Ӳͬʼ
+        for (;;) {
+            // ӵǰһеַԭӵػȡȷÿ IP ֻһ̴߳
+            size_t j = 0;
+            uint64_t idx = 0;
+            bool found = false;
+            for (size_t k = 0; k < jobs.size() && !found; ++k) {
+                j = (cursor + k) % jobs.size();
+                idx = cursors[j]->next.fetch_add(1);
+                found = idx < jobs[j].hostCount;
+            }
+            if (!found) break; //  IP ѷ䣬߳˳
+            cursor = j + 1;    // һַһͬʱƽ
+
+            SubnetJob& job = jobs[j];
+            JobCursor& jc = *cursors[j];
+            const uint32_t host = jc.walk.at(idx);
+            // һַʱʱ
+            auto complete = [&]() {
+                if (jc.completed.fetch_add(1) + 1 == job.hostCount) {
+                    jc.finishNs.store(TokenBucket::nowNs() - startNs);
+                }
+            };
+            if (job.accept && !job.accept(host)) { // ɨʱδڵĵַ
+                complete();
+                continue;
+            }
+
+            // 
+            AdapterLimit& limit = *limits[job.adapter];
+            for (;;) {
+                uint64_t wait = 0;
+                {
+                    lock_guard<mutex> lk(limit.lock);
+                    const uint64_t now = TokenBucket::nowNs();
+                    if (limit.bucket.take(now, 1) == 1) break;
+                    wait = limit.bucket.waitNs(now);
+                }
+                this_thread::sleep_for(chrono::nanoseconds(wait));
+            }
+
+            uint32_t candidate = htonl(host); // ȡҪɨ IP ַתΪ SendARP Ҫֽ
+            BYTE macAddr[8] = { 0 }; // 洢 MAC ַĻ
+            ULONG macAddrLen = sizeof(macAddr);
+
+            //  ARP 
+            DWORD arpRet = SendARP((IPAddr)candidate, 0, macAddr, &macAddrLen);
+            jc.probed.fetch_add(1, memory_order_relaxed);
+
+            //  ARP ɹҷЧġ MAC ַ
+            if (arpRet == NO_ERROR && macAddrLen == 6 && !isZeroMac(macAddr, macAddrLen)) {
+                FoundHost hostFound;
+                hostFound.ip = host;
+                memcpy(hostFound.mac, macAddr, 6);
+                out.hosts.emplace_back(j, hostFound);
+                jc.answered.fetch_add(1, memory_order_relaxed);
+            }
+            else {
+                out.missed.emplace_back(j, host);
+            }
+            complete();
+        }
+        };
+
+    ProgressLine progress(opt.progress, totalHosts, [&](uint64_t& walked, uint64_t& answered) {
+        walked = answered = 0;
+        for (const auto& jc : cursors) {
+            walked += jc->completed.load(memory_order_relaxed);
+            answered += jc->answered.load(memory_order_relaxed);
+        }
+    });
+
+    // ߳
+    vector<thread> threads;
+    threads.reserve(maxThreads);
+    for (unsigned int t = 0; t < maxThreads; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    // ȴ߳
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    // ϲ̵߳Ľ
+    for (const WorkerOutput& out : outputs) {
+        for (const auto& h : out.hosts) jobs[h.first].result.hosts.push_back(h.second);
+        for (const auto& m : out.missed) jobs[m.first].result.missed.push_back(m.second);
+    }
+    for (size_t j = 0; j < jobs.size(); ++j) {
+        SweepStats& st = jobs[j].stats;
+        st.probed = st.sent = cursors[j]->probed.load();
+        st.answered = cursors[j]->answered.load();
+        st.seconds = (double)cursors[j]->finishNs.load() / 1e9;
+    }
+}
+
+#else
+
+/**
+ * @brief ԭʼ׽ͬʱɨÿӿһ׽֡٣
+ *        ȫӿڹһ߳һ̶ֻ̣߳߳ѽд飬
+ * @param jobs ɨͳ
+ * @param adapters б
+ * @param opt ѡ
+ */
+static void scanWithSweeper(vector<SubnetJob>& jobs, const vector<Adapter>& adapters, const Options& opt) {
+    ArpSweeper sweeper;
+    vector<int> ifaceOf(adapters.size(), -2); // ӦĽӿڱţ-2 δ򿪣-1 ʧ
+    vector<size_t> jobOf;                     // ɨеӦ
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        SubnetJob& job = jobs[i];
+        int& iface = ifaceOf[job.adapter];
+        if (iface == -2) {
+            const string& name = adapters[job.adapter].name;
+            iface = sweeper.addInterface(name.c_str(), ppsFor(opt, name));
+            if (iface < 0) {
+                cout << WarningMsg << "޷ " << name << " ɨ: " << sweeper.error() << endl;
+            }
+        }
+        if (iface < 0) {
+            job.skipped = true;
+            continue;
+        }
+        sweeper.addJob(iface, job.ip, job.start, job.hostCount, job.accept);
+        jobOf.push_back(i);
+    }
+    if (jobOf.empty()) {
+        return;
+    }
+
+    uint64_t totalHosts = 0;
+    for (size_t i : jobOf) totalHosts += jobs[i].hostCount;
+    auto saveStats = [&]() {
+        for (size_t j = 0; j < jobOf.size(); ++j) {
+            jobs[jobOf[j]].stats = sweeper.stats(j);
+        }
+    };
+
+    ProgressLine progress(opt.progress, totalHosts, [&](uint64_t& walked, uint64_t& answered) {
+        sweeper.progress(walked, answered);
+    });
+    // --- ĵַΪѷ֣ɨʱ̽ ---
+    if (opt.passiveSec > 0) {
+        cout << InformationMsg << " " << jobOf.size() << "  ARP  " << opt.passiveSec << " ..." << endl;
+        sweeper.listen((uint64_t)opt.passiveSec * 1000, [&](size_t j, uint32_t host, const uint8_t* mac) {
+            FoundHost found;
+            found.ip = host;
+            memcpy(found.mac, mac, 6);
+            jobs[jobOf[j]].result.heard.push_back(found);
+        });
+        if (opt.noProbe) {
+            saveStats();
+            return;
+        }
+    }
+
+    cout << InformationMsg << "첽ɨ " << jobOf.size() << " ,  " << totalHosts << " ַ (ط "
+         << opt.sweep.retries << " , ʱ " << opt.sweep.timeoutMs << " ms)..." << endl;
+    // Ӧصֻڽ߳еãδӦصֻڷ߳еãдĽ
+    sweeper.run(opt.sweep, [&](size_t j, uint32_t host, const uint8_t* mac) {
+        SubnetJob& job = jobs[jobOf[j]];
+        FoundHost found;
+        found.ip = host;
+        memcpy(found.mac, mac, 6);
+        job.result.hosts.push_back(found);
+    }, [&](size_t j, uint32_t host) {
+        jobs[jobOf[j]].result.missed.push_back(host);
+    });
+    saveStats();
+}
+
+#endif
+
+/**
+ * @brief ϲĽ IP һ
+ */
+static void reportHosts(const vector<SubnetJob>& jobs) {
+    struct Row {
+        uint32_t ip;
+        size_t job;
+        const FoundHost* host;
+        const char* note; // Դ
+    };
+    vector<Row> rows;
+    for (size_t j = 0; j < jobs.size(); ++j) {
+        for (const FoundHost& h : jobs[j].result.cached) rows.push_back(Row{ h.ip, j, &h, " \033[36m()\033[0m" });
+        for (const FoundHost& h : jobs[j].result.heard) rows.push_back(Row{ h.ip, j, &h, " \033[36m()\033[0m" });
+        for (const FoundHost& h : jobs[j].result.hosts) rows.push_back(Row{ h.ip, j, &h, "" });
+    }
+    sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+        return a.ip != b.ip ? a.ip < b.ip : a.job < b.job;
+    });
+
+    cout << flush; // ֱ֮д׼ cout Ļ屣֤˳
+    TextBuffer out;
+    for (const Row& r : rows) {
+        appendHost(out, jobs[r.job].tag, r.ip, r.host->mac, 6, r.note);
+        out.flushIfFull();
+    }
+    out.flush();
+}
+
+/**
+ * @brief ɨǷһδַ֪ÿвͬк󸲸
+ */
+static bool sampled(uint32_t ip, uint32_t seed, uint64_t threshold) {
+    uint32_t h = (ip ^ seed) * 0x9E3779B1u;
+    h ^= h >> 15;
+    h *= 0x85EBCA77u;
+    h ^= h >> 13;
+    return h < threshold;
+}
+
+/**
+ * @brief ׼ɨ裺»δڵֻйĿδַ֪Ĺ
+ */
+static ArpSweeper::TargetFilter planIncremental(const NeighborCache& cache, const Options& opt, SubnetJob& job, uint32_t now) {
+    uint64_t fresh = 0, stale = 0;
+    for (const NeighborEntry* e = cache.lowerBound(job.start); e != cache.end() && (uint64_t)(e->ip - job.start) < job.hostCount; ++e) {
+        if (now - e->lastSeen < opt.ttl) {
+            FoundHost h;
+            h.ip = e->ip;
+            memcpy(h.mac, e->mac, 6);
+            job.result.cached.push_back(h);
+            ++fresh;
+        }
+        else {
+            ++stale;
+        }
+    }
+    cout << InformationMsg << "\033[36m[" << job.tag << "]\033[0m  " << fresh << " ̨δ, " << stale << " ̨Ҫ̽, ̽ "
+         << opt.samplePercent << "% δַ֪" << endl;
+
+    random_device rd;
+    const uint32_t seed = rd();
+    const uint64_t threshold = (uint64_t)opt.samplePercent * 0x100000000ull / 100;
+    const uint32_t ttl = opt.ttl;
+    return [&cache, now, ttl, seed, threshold](uint32_t host) {
+        const NeighborEntry* e = cache.find(host);
+        if (e) return now - e->lastSeen >= ttl;
+        return sampled(host, seed, threshold);
+    };
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        return 1;
+    }
+#ifdef _WIN32
     // ʼ Winsock
     WSADATA wsaData;
     if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
         cerr << ErrorMsg << "WSAStartup failed" << endl;
         return 1;
     }
+#endif
 
     // --- ȡϢ ---
-    ULONG outBufLen = 0;
-    // һε GetAdaptersInfo nullptrԻȡĻС
-    DWORD dwRet = GetAdaptersInfo(nullptr, &outBufLen);
-    if (dwRet != ERROR_BUFFER_OVERFLOW) {
-        cerr << ErrorMsg << "GetAdaptersInfo failed to get buffer size: " << dwRet << endl;
+    vector<Adapter> adapters;
+    string error;
+    if (!listAdapters(adapters, error)) {
+        cerr << ErrorMsg << error << endl;
+#ifdef _WIN32
         WSACleanup();
+#endif
         return 1;
     }
 
-    // ݻȡĴС仺
-    vector<BYTE> buffer(outBufLen);
-    PIP_ADAPTER_INFO pAdapterInfo = reinterpret_cast<PIP_ADAPTER_INFO>(buffer.data());
-
-    // ڶε GetAdaptersInfoõĻԻȡϢ
-    dwRet = GetAdaptersInfo(pAdapterInfo, &outBufLen);
-    if (dwRet != NO_ERROR) {
-        cerr << ErrorMsg << "GetAdaptersInfo failed: " << dwRet << endl;
-        WSACleanup();
-        return 1;
+    // --- ھӻ ---
+    NeighborCache cache;
+    const bool useCache = !opt.cachePath.empty();
+    const uint32_t now = (uint32_t)time(nullptr);
+    if (useCache) {
+        if (!cache.load(opt.cachePath)) {
+            cerr << ErrorMsg << cache.error() << endl;
+#ifdef _WIN32
+            WSACleanup();
+#endif
+            return 1;
+        }
+        cout << InformationMsg << "ھӻ " << opt.cachePath << ": " << cache.size() << " " << endl;
     }
 
     cout << InformationMsg << "ɨ" << endl;
-   
-    // ---  ---
-    for (PIP_ADAPTER_INFO pAdapter = pAdapterInfo; pAdapter != nullptr; pAdapter = pAdapter->Next) {
+
+    // --- ռÿɨ ---
+    vector<SubnetJob> jobs;
+    for (size_t a = 0; a < adapters.size(); ++a) {
+        const Adapter& adapter = adapters[a];
         cout << endl << InformationMsg << "\033[32m--------------------------[Ϣ]--------------------------\033[0m\t" << endl;
-        cout << InformationMsg << "\033[33m:\033[0m" << pAdapter->AdapterName << " (" << pAdapter->Description << ")" << endl;
-        cout << InformationMsg << "\033[33mMAC: \033[0m" << formatMac(pAdapter->Address, pAdapter->AddressLength) << endl;
+        cout << InformationMsg << "\033[33m:\033[0m" << adapter.name << " (" << adapter.description << ")" << endl;
+        TextBuffer& macLine = threadTextBuffer();
+        macLine.clear();
+        formatMac(macLine.put(InformationMsg).put("\033[33mMAC: \033[0m"), adapter.mac, adapter.macLen).put('\n');
+        cout.write(macLine.data(), (streamsize)macLine.size());
 
         // --- ÿ IP ַ ---
-        for (IP_ADDR_STRING* ipAddr = &pAdapter->IpAddressList; ipAddr != nullptr; ipAddr = ipAddr->Next) {
-            if (ipAddr->IpAddress.String[0] == '\0') break; //  IP ַַΪգֹͣ
-            string ipStr = ipAddr->IpAddress.String;
-            string maskStr = ipAddr->IpMask.String;
-
+        for (const AdapterAddress& addr : adapter.addresses) {
             // Ч "0.0.0.0" ַ
-            if (ipStr == "0.0.0.0") continue;
+            if (addr.ip == 0) continue;
 
-            cout << InformationMsg << "\033[33mIP: \033[0m" << ipStr << "\033[33m : \033[0m" << maskStr << "\033[33m : \033[0m" << pAdapter->GatewayList.IpAddress.String << endl;
-			cout << InformationMsg << "\033[32m[ʼɨ...]\033[0m\t" << endl;
+            TextBuffer& info = threadTextBuffer();
+            info.clear();
+            info.put(InformationMsg).put("\033[33mIP: \033[0m").ipv4(addr.ip).put("\033[33m : \033[0m").ipv4(addr.mask)
+                .put("\033[33m : \033[0m").ipv4(adapter.gateway).put('\n');
+            cout.write(info.data(), (streamsize)info.size());
 
             // --- Χ ---
-            uint32_t ip = ntohl(inet_addr(ipStr.c_str()));   // ʮ IP ַתΪֽתΪֽ
-            uint32_t mask = ntohl(inet_addr(maskStr.c_str())); // ͬϴ
+            uint32_t ip = addr.ip;
+            uint32_t mask = addr.mask;
             if (mask == 0) continue; // Ч
 
             uint32_t network = ip & mask;                     // ַ
@@ -124,75 +666,79 @@ int main() {
                 cout << WarningMsg << "No hosts to scan on this interface." << endl;
                 continue;
             }
-            // ɨ /16ĴʱԴ
-            if (hostCount > 65534) {
-                cout << WarningMsg << "Subnet too large (" << hostCount << " hosts). Skipping detailed scan." << endl;
-                continue;
-            }
 
-            // Ҫɨ IP ַбֽ
-            vector<uint32_t> candidates;
-            candidates.reserve(static_cast<size_t>(hostCount));
-            for (uint32_t h = start; h <= end; ++h) {
-                candidates.push_back(htonl(h)); // ֽΪ SendARP Ҫָʽ
-            }
+            SubnetJob job;
+            int prefix = 0;
+            for (uint32_t m = mask; m & 0x80000000u; m <<= 1) ++prefix;
+            TextBuffer& tag = threadTextBuffer();
+            tag.clear();
+            tag.put(adapter.name).put(' ').ipv4(network).put('/').dec((uint64_t)prefix);
+            job.tag.assign(tag.data(), tag.size());
+            job.adapter = a;
+            job.ip = ip;
+            job.start = start;
+            job.hostCount = hostCount;
 
-            // --- ߳ɨ ---
-            // ȷҪʹõ߳
-            unsigned int hc = thread::hardware_concurrency(); // ȡӲֵ֧Ĳ߳
-            if (hc == 0) hc = 4; // ޷ȡĬΪ 4
-            unsigned int maxThreads = hc;
-            if (maxThreads > 64) maxThreads = 64; // ߳Ϊ 64
-            if (maxThreads > candidates.size()) maxThreads = static_cast<unsigned int>(candidates.size()); // ߳ IP 
-            if (maxThreads == 0) maxThreads = 1; // ʹһ߳
-
-            cout << InformationMsg << "ʹ " << maxThreads << " ߳ɨ " << candidates.size() << " ̨..." << endl;
-
-            atomic<size_t> nextIndex(0); // ԭӼ̰߳ȫط
-            mutex printMutex;            // ڱ cout ֹ߳ͬʱд뵼»
-
-            // ̺߳
-            auto worker = [&](unsigned int /*threadId*/) {
-                for (;;) {
-                    // ԭӵػȡȷÿ IP ֻһ̴߳
-                    size_t idx = nextIndex.fetch_add(1);
-                    if (idx >= candidates.size()) break; //  IP ѷ䣬߳˳
-
-                    uint32_t candidate = candidates[idx]; // ȡҪɨ IP ַ
-                    BYTE macAddr[8] = { 0 }; // 洢 MAC ַĻ
-                    ULONG macAddrLen = sizeof(macAddr);
-
-                    //  ARP 
-                    DWORD arpRet = SendARP((IPAddr)candidate, 0, macAddr, &macAddrLen);
-
-                    //  ARP ɹҷЧġ MAC ַ
-                    if (arpRet == NO_ERROR && macAddrLen > 0 && !isZeroMac(macAddr, macAddrLen)) {
-                        in_addr a;
-                        a.S_un.S_addr = candidate;
-                        const char* ipBuf = inet_ntoa(a); //  IP ַתַʽ
-                        string macs = formatMac(macAddr, macAddrLen); // ʽ MAC ַ
-
-                        // ʹų̂
-                        lock_guard<mutex> lk(printMutex);
-                        cout << InformationMsg << "\033[33mIP: \033[0m" << ipBuf << "\033[33m ---> \033[0m" << "\033[33mMAC: \033[0m" << macs << endl;
-                    }
+            // --- ھӻ棺ϵͳھӱɨʱֻ̽ĵַ ---
+            if (useCache) {
+                const size_t seeded = cache.seedFromSystem(start, hostCount, now);
+                cache.commit();
+                if (seeded > 0) {
+                    cout << InformationMsg << "ϵͳھӱ " << seeded << " " << endl;
+                }
+                if (opt.incremental) {
+                    job.accept = planIncremental(cache, opt, job, now);
                 }
-                };
-
-            // ߳
-            vector<thread> threads;
-            threads.reserve(maxThreads);
-            for (unsigned int t = 0; t < maxThreads; ++t) {
-                threads.emplace_back(worker, t);
-            }
-            // ȴ߳
-            for (auto& th : threads) {
-                th.join();
             }
+            jobs.push_back(move(job));
         } //  IP ַ
     } // 
 
+    // --- ͬʱɨ ---
+    if (!jobs.empty()) {
+        cout << endl << InformationMsg << "\033[32m[ʼɨ...]\033[0m\t" << endl;
+#ifdef _WIN32
+        scanWithSendArp(jobs, adapters, opt);
+#else
+        scanWithSweeper(jobs, adapters, opt);
+#endif
+        reportHosts(jobs);
+        cout << endl;
+    }
+
+    // --- ͳƣɨдھӻ ---
+    for (SubnetJob& job : jobs) {
+        cout << InformationMsg << "\033[36m[" << job.tag << "]\033[0m ";
+        if (job.skipped) {
+            cout << "δɨ" << endl;
+            continue;
+        }
+        if (opt.passiveSec > 0) {
+            cout << " " << job.stats.heard << " ̨, ";
+        }
+        cout << "̽ " << job.stats.probed << " ַ,  " << job.stats.sent << " ,  " << job.stats.answered
+             << " ̨, ʱ " << (uint64_t)(job.stats.seconds * 1000) << " ms" << endl;
+        if (useCache) {
+            // ȼδӦټӦ𣺳ʱŵӦ
+            for (uint32_t host : job.result.missed) cache.miss(host);
+            for (const FoundHost& h : job.result.heard) cache.observe(h.ip, h.mac, now);
+            for (const FoundHost& h : job.result.hosts) cache.observe(h.ip, h.mac, now);
+            cache.commit();
+        }
+    }
+
+    if (useCache) {
+        if (cache.save(opt.cachePath)) {
+            cout << InformationMsg << "ھӻѱ: " << cache.size() << " " << endl;
+        }
+        else {
+            cerr << ErrorMsg << cache.error() << endl;
+        }
+    }
+
+#ifdef _WIN32
     //  Winsock
     WSACleanup();
+#endif
     return 0;
-}
\ No newline at end of file
+}
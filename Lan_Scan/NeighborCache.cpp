@@ -0,0 +1,313 @@
+// ĳЩµ Visual Studio 汾УһЩͳ Winsock Ϊá˺Խùʹþɰ Winsock ľ档
+#define _WINSOCK_DEPRECATED_NO_WARNINGS
+// ʹ fopen ȴͳ CRT 
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "NeighborCache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <iphlpapi.h>
+#include <windows.h>
+#pragma comment(lib, "iphlpapi.lib")
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+const char CACHE_MAGIC[4] = { 'L', 'S', 'N', 'C' };
+
+inline uint32_t rdLE(const unsigned char* p, int bytes) {
+    uint32_t v = 0;
+    for (int i = bytes - 1; i >= 0; --i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+inline void wrLE(unsigned char* p, uint32_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        p[i] = (unsigned char)(v >> (8 * i));
+    }
+}
+
+inline bool byIp(const NeighborEntry& a, const NeighborEntry& b) {
+    return a.ip < b.ip;
+}
+
+/**
+ * @brief ֻӳļʱӳ
+ */
+class MappedFile {
+public:
+    ~MappedFile() {
+#ifdef _WIN32
+        if (view) UnmapViewOfFile(view);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (view) munmap(view, size);
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    /**
+     * @return ļʱ exists Ϊ false  false
+     */
+    bool open(const char* path, bool& exists) {
+        exists = true;
+#ifdef _WIN32
+        file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            exists = GetLastError() != ERROR_FILE_NOT_FOUND;
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || (unsigned long long)fileSize.QuadPart > (unsigned long long)SIZE_MAX) return false;
+        size = (size_t)fileSize.QuadPart;
+        if (size == 0) return true;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return false;
+        view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) return false;
+#else
+        fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            exists = errno != ENOENT;
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) return false;
+        if ((unsigned long long)st.st_size > (unsigned long long)SIZE_MAX) return false;
+        size = (size_t)st.st_size;
+        if (size == 0) return true;
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) return false;
+        view = p;
+#endif
+        return true;
+    }
+
+    const unsigned char* data() const {
+        return (const unsigned char*)view;
+    }
+
+    size_t length() const {
+        return size;
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+    void* view = nullptr;
+    size_t size = 0;
+};
+
+} // namespace
+
+bool NeighborCache::load(const string& path) {
+    entries.clear();
+    added.clear();
+    MappedFile file;
+    bool exists = true;
+    if (!file.open(path.c_str(), exists)) {
+        if (!exists) return true; // һʹãӿջ濪ʼ
+        err = "޷ȡھӻ " + path;
+        return false;
+    }
+    const unsigned char* p = file.data();
+    const size_t len = file.length();
+    if (len < NEIGHBOR_CACHE_HEADER_SIZE || memcmp(p, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0) {
+        err = path + " ھӻļ";
+        return false;
+    }
+    const uint32_t version = rdLE(p + 4, 2);
+    const uint32_t entrySize = rdLE(p + 6, 2);
+    const uint32_t count = rdLE(p + 8, 4);
+    if (version != NEIGHBOR_CACHE_VERSION || entrySize != sizeof(NeighborEntry)) {
+        err = path + " İ汾֧";
+        return false;
+    }
+    if ((len - NEIGHBOR_CACHE_HEADER_SIZE) / sizeof(NeighborEntry) < count) {
+        err = path + " ";
+        return false;
+    }
+    // ¼ڴ沼֣θ
+    entries.resize(count);
+    if (count > 0) {
+        memcpy(entries.data(), p + NEIGHBOR_CACHE_HEADER_SIZE, (size_t)count * sizeof(NeighborEntry));
+    }
+    if (!is_sorted(entries.begin(), entries.end(), byIp)) {
+        sort(entries.begin(), entries.end(), byIp);
+    }
+    return true;
+}
+
+bool NeighborCache::save(const string& path) {
+    commit();
+    const string temp = path + ".tmp";
+    FILE* fp = fopen(temp.c_str(), "wb");
+    if (!fp) {
+        err = "޷д " + temp;
+        return false;
+    }
+    unsigned char header[NEIGHBOR_CACHE_HEADER_SIZE] = { 0 };
+    memcpy(header, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    wrLE(header + 4, NEIGHBOR_CACHE_VERSION, 2);
+    wrLE(header + 6, sizeof(NeighborEntry), 2);
+    wrLE(header + 8, (uint32_t)entries.size(), 4);
+    bool failed = fwrite(header, 1, sizeof(header), fp) != sizeof(header);
+    if (!entries.empty()) {
+        failed |= fwrite(entries.data(), sizeof(NeighborEntry), entries.size(), fp) != entries.size();
+    }
+    failed |= fclose(fp) != 0;
+    if (failed) {
+        remove(temp.c_str());
+        err = "д " + temp + " ʧ";
+        return false;
+    }
+    remove(path.c_str()); // Windows  rename Ḳļ
+    if (rename(temp.c_str(), path.c_str()) != 0) {
+        remove(temp.c_str());
+        err = "޷滻 " + path;
+        return false;
+    }
+    return true;
+}
+
+size_t NeighborCache::seedFromSystem(uint32_t first, uint64_t count, uint32_t now) {
+    size_t n = 0;
+    auto inRange = [&](uint32_t ip) {
+        return (uint64_t)(uint32_t)(ip - first) < count;
+    };
+#ifdef _WIN32
+    ULONG size = 0;
+    if (GetIpNetTable(nullptr, &size, FALSE) != ERROR_INSUFFICIENT_BUFFER) {
+        return 0;
+    }
+    vector<BYTE> buffer(size);
+    PMIB_IPNETTABLE table = reinterpret_cast<PMIB_IPNETTABLE>(buffer.data());
+    if (GetIpNetTable(table, &size, FALSE) != NO_ERROR) {
+        return 0;
+    }
+    for (DWORD i = 0; i < table->dwNumEntries; ++i) {
+        const MIB_IPNETROW& row = table->table[i];
+        // ֻȡѽĶ̬̬Ŀ
+        if ((row.dwType != MIB_IPNET_TYPE_DYNAMIC && row.dwType != MIB_IPNET_TYPE_STATIC) || row.dwPhysAddrLen != 6) {
+            continue;
+        }
+        const uint32_t ip = ntohl(row.dwAddr);
+        if (!inRange(ip)) continue;
+        observe(ip, row.bPhysAddr, now);
+        ++n;
+    }
+#else
+    FILE* fp = fopen("/proc/net/arp", "r");
+    if (!fp) {
+        return 0;
+    }
+    char line[256];
+    // Ϊ IP address, HW type, Flags, HW address, Mask, DeviceһǱ
+    while (fgets(line, sizeof(line), fp)) {
+        char ipText[64];
+        unsigned int hwType = 0, flags = 0;
+        unsigned int m[6];
+        if (sscanf(line, "%63s %x %x %x:%x:%x:%x:%x:%x", ipText, &hwType, &flags,
+                   &m[0], &m[1], &m[2], &m[3], &m[4], &m[5]) != 9) {
+            continue;
+        }
+        struct in_addr addr;
+        if (hwType != 1 || (flags & 0x2) == 0 || inet_pton(AF_INET, ipText, &addr) != 1) {
+            continue; // ֻȡ̫ѽ (ATF_COM) Ŀ
+        }
+        const uint32_t ip = ntohl(addr.s_addr);
+        if (!inRange(ip)) continue;
+        uint8_t mac[6];
+        for (int i = 0; i < 6; ++i) mac[i] = (uint8_t)m[i];
+        observe(ip, mac, now);
+        ++n;
+    }
+    fclose(fp);
+#endif
+    return n;
+}
+
+const NeighborEntry* NeighborCache::lowerBound(uint32_t ip) const {
+    NeighborEntry key;
+    key.ip = ip;
+    return entries.data() + (lower_bound(entries.begin(), entries.end(), key, byIp) - entries.begin());
+}
+
+const NeighborEntry* NeighborCache::find(uint32_t ip) const {
+    const NeighborEntry* e = lowerBound(ip);
+    return (e != end() && e->ip == ip) ? e : nullptr;
+}
+
+NeighborEntry* NeighborCache::findMutable(uint32_t ip) {
+    return const_cast<NeighborEntry*>(find(ip));
+}
+
+void NeighborCache::observe(uint32_t ip, const uint8_t* mac, uint32_t now) {
+    NeighborEntry* e = findMutable(ip);
+    if (e) {
+        memcpy(e->mac, mac, 6);
+        e->lastSeen = now;
+        e->misses = 0;
+        return;
+    }
+    NeighborEntry n;
+    n.ip = ip;
+    n.firstSeen = now;
+    n.lastSeen = now;
+    n.misses = 0;
+    memcpy(n.mac, mac, 6);
+    added.push_back(n);
+}
+
+void NeighborCache::miss(uint32_t ip) {
+    NeighborEntry* e = findMutable(ip);
+    if (e && e->misses < 0xFFFF) {
+        ++e->misses;
+    }
+}
+
+void NeighborCache::commit() {
+    // ͬһַݴʱһ
+    stable_sort(added.begin(), added.end(), byIp);
+    size_t kept = 0;
+    for (size_t i = 0; i < added.size(); ++i) {
+        if (kept > 0 && added[kept - 1].ip == added[i].ip) {
+            added[kept - 1] = added[i];
+        }
+        else {
+            added[kept++] = added[i];
+        }
+    }
+    added.resize(kept);
+
+    const size_t middle = entries.size();
+    entries.insert(entries.end(), added.begin(), added.end());
+    inplace_merge(entries.begin(), entries.begin() + middle, entries.end(), byIp);
+    added.clear();
+
+    entries.erase(remove_if(entries.begin(), entries.end(), [](const NeighborEntry& e) {
+        return e.misses >= NEIGHBOR_MAX_MISSES;
+    }), entries.end());
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ------------------ ھӻ ------------------
+// ļʽСˣ
+//   ļͷ 16 ֽڣħ "LSNC"汾 (2)ÿ¼ֽ (2)¼ (4) (4)
+//   ֮Ϊ IP еĶ¼ NeighborEntry ڴ沼
+
+const uint16_t NEIGHBOR_CACHE_VERSION = 1;
+const size_t NEIGHBOR_CACHE_HEADER_SIZE = 16;
+const uint16_t NEIGHBOR_MAX_MISSES = 3; // ôɨδӦĿӻɾ
+
+/**
+ * @brief еһ̨
+ */
+struct NeighborEntry {
+    uint32_t ip;        // ֽ
+    uint32_t firstSeen; // һηֵʱ䣨Unix 룩
+    uint32_t lastSeen;  // һӦʱ䣨Unix 룩
+    uint16_t misses;    // һӦ֮δӦɨ
+    uint8_t mac[6];
+};
+static_assert(sizeof(NeighborEntry) == 20, "NeighborEntry ļеļ¼ʽ");
+
+/**
+ * @brief ־û IP  MAC 棬ɨʱֻ̽ڵĿ
+ *
+ * Ŀ IP 򱣴УΪֲҡɨ·ֵݴ棬
+ * commit() ʱһκϲ飬ɨڼ find() ݲ䡣
+ * ̰߳ȫģɨֻ߳ʱԲ find()
+ */
+class NeighborCache {
+public:
+    /**
+     * @brief ڴӳķʽ뻺ļ
+     * @param path ļ·ļʱõջ
+     * @return ļڵ޷ȡʽʱ falseԭ error()
+     */
+    bool load(const std::string& path);
+
+    /**
+     * @brief д뻺ļдʱļ滻дһʧʱԭļӰ
+     */
+    bool save(const std::string& path);
+
+    const std::string& error() const {
+        return err;
+    }
+
+    /**
+     * @brief ϵͳھӱ [first, first + count) ѽĿΪ˿̸ոӦ
+     *        Linux  /proc/net/arpWindows  GetIpNetTableҪ commit()
+     * @param now ǰʱ䣨Unix 룩
+     * @return Ŀ
+     */
+    size_t seedFromSystem(uint32_t first, uint64_t count, uint32_t now);
+
+    /**
+     * @brief һַûʱ nullptrδ commit() Ŀ
+     */
+    const NeighborEntry* find(uint32_t ip) const;
+
+    /**
+     * @brief һ IP С ip Ŀend() ʾû
+     */
+    const NeighborEntry* lowerBound(uint32_t ip) const;
+    const NeighborEntry* end() const {
+        return entries.data() + entries.size();
+    }
+
+    size_t size() const {
+        return entries.size();
+    }
+
+    /**
+     * @brief ¼һӦδӦ MAC Ӧʱ
+     */
+    void observe(uint32_t ip, const uint8_t* mac, uint32_t now);
+
+    /**
+     * @brief ¼һ̽δӦֻӰĿ
+     */
+    void miss(uint32_t ip);
+
+    /**
+     * @brief ϲݴĿɾδӦﵽ NEIGHBOR_MAX_MISSES εĿ
+     */
+    void commit();
+
+private:
+    NeighborEntry* findMutable(uint32_t ip);
+
+    std::vector<NeighborEntry> entries; //  IP 
+    std::vector<NeighborEntry> added;   // δϲĿ
+    std::string err;
+};
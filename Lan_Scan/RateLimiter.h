@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// ------------------  ------------------
+
+/**
+ * @brief Ͱÿ벹 rate ƣ burst rate Ϊ 0 ʾ
+ *
+ * ̰߳ȫģ̹߳ʱɵ߼
+ */
+class TokenBucket {
+public:
+    TokenBucket() = default;
+
+    TokenBucket(double rate, double burst)
+        : rate(rate), burst(burst < 1 ? 1 : burst), tokens(this->burst), last(nowNs()) {
+    }
+
+    bool limited() const {
+        return rate > 0;
+    }
+
+    /**
+     * @brief ȡ want 
+     * @return ʵȡĸʱΪ want
+     */
+    size_t take(uint64_t now, size_t want) {
+        if (rate <= 0) {
+            return want;
+        }
+        refill(now);
+        const size_t n = tokens < (double)want ? (size_t)tokens : want;
+        tokens -= (double)n;
+        return n;
+    }
+
+    /**
+     * @brief 黹 take() ȡûϵ
+     */
+    void refund(size_t n) {
+        if (rate > 0) {
+            tokens += (double)n;
+        }
+    }
+
+    /**
+     * @brief һƿûҪ룬ƻʱΪ 0
+     */
+    uint64_t waitNs(uint64_t now) {
+        if (rate <= 0) {
+            return 0;
+        }
+        refill(now);
+        return tokens >= 1 ? 0 : (uint64_t)((1 - tokens) * 1e9 / rate) + 1;
+    }
+
+    static uint64_t nowNs() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    void refill(uint64_t now) {
+        if (now > last) {
+            tokens += (double)(now - last) * rate / 1e9;
+            if (tokens > burst) tokens = burst;
+            last = now;
+        }
+    }
+
+    double rate = 0;
+    double burst = 1;
+    double tokens = 1;
+    uint64_t last = 0;
+};